@@ -0,0 +1,107 @@
+#include "abs-capture-time.hpp"
+
+extern "C" {
+G_BEGIN_DECLS
+#define GST_TYPE_RTP_HEADER_EXTENSION_ABS_CAPTURE_TIME (gst_rtp_header_extension_abs_capture_time_get_type())
+
+struct GstRTPHeaderExtensionAbsCaptureTime {
+    GstRTPHeaderExtension parent;
+};
+
+struct GstRTPHeaderExtensionAbsCaptureTimeClass {
+    GstRTPHeaderExtensionClass parent_class;
+};
+
+GType gst_rtp_header_extension_abs_capture_time_get_type(void);
+G_END_DECLS
+}
+
+#define gst_rtp_header_extension_abs_capture_time_parent_class parent_class
+G_DEFINE_TYPE(GstRTPHeaderExtensionAbsCaptureTime, gst_rtp_header_extension_abs_capture_time, GST_TYPE_RTP_HEADER_EXTENSION);
+
+namespace {
+// 64-bit UQ32.32 NTP timestamp, the optional clock offset is not sent
+constexpr auto extension_size = 8;
+
+// seconds between 1900-01-01 and 1970-01-01
+constexpr auto ntp_unix_epoch_diff = guint64(2208988800);
+
+GstStaticCaps meta_caps         = GST_STATIC_CAPS("timestamp/x-ntp");
+GstStaticCaps latency_meta_caps = GST_STATIC_CAPS("timestamp/x-jitsi-capture-latency");
+
+auto get_supported_flags(GstRTPHeaderExtension* const /*ext*/) -> GstRTPHeaderExtensionFlags {
+    return GstRTPHeaderExtensionFlags(GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE);
+}
+
+auto get_max_size(GstRTPHeaderExtension* const /*ext*/, const GstBuffer* const /*input_meta*/) -> gsize {
+    return extension_size;
+}
+
+auto write_extension(GstRTPHeaderExtension* const /*ext*/,
+                     const GstBuffer* const input_meta,
+                     const GstRTPHeaderExtensionFlags /*write_flags*/,
+                     GstBuffer* const /*output*/,
+                     guint8* const data,
+                     const gsize   size) -> gssize {
+    g_return_val_if_fail(size >= extension_size, -1);
+
+    // prefer capture time provided by upstream, fallback to the time of payloading
+    auto       capture_time = abs_capture_time_now();
+    const auto meta         = gst_buffer_get_reference_timestamp_meta(const_cast<GstBuffer*>(input_meta), abs_capture_time_meta_caps());
+    if(meta != NULL) {
+        capture_time = meta->timestamp;
+    }
+    GST_WRITE_UINT64_BE(data, gst_util_uint64_scale(capture_time, guint64(1) << 32, GST_SECOND));
+    return extension_size;
+}
+
+auto read_extension(GstRTPHeaderExtension* const /*ext*/,
+                    const GstRTPHeaderExtensionFlags /*read_flags*/,
+                    const guint8* const data,
+                    const gsize         size,
+                    GstBuffer* const    buffer) -> gboolean {
+    if(size < extension_size) {
+        return FALSE;
+    }
+    const auto capture_time = gst_util_uint64_scale(GST_READ_UINT64_BE(data), GST_SECOND, guint64(1) << 32);
+    gst_buffer_add_reference_timestamp_meta(buffer, abs_capture_time_meta_caps(), capture_time, GST_CLOCK_TIME_NONE);
+    return TRUE;
+}
+} // namespace
+
+auto gst_rtp_header_extension_abs_capture_time_init(GstRTPHeaderExtensionAbsCaptureTime* /*ext*/) -> void {
+}
+
+auto gst_rtp_header_extension_abs_capture_time_class_init(GstRTPHeaderExtensionAbsCaptureTimeClass* klass) -> void {
+    const auto ext_class           = (GstRTPHeaderExtensionClass*)(klass);
+    ext_class->get_supported_flags = get_supported_flags;
+    ext_class->get_max_size        = get_max_size;
+    ext_class->write               = write_extension;
+    ext_class->read                = read_extension;
+    gst_rtp_header_extension_class_set_uri(ext_class, rtp_hdrext_abs_capture_time_uri);
+
+    const auto element_class = (GstElementClass*)(klass);
+    gst_element_class_set_static_metadata(element_class,
+                                          "Absolute Capture Time",
+                                          GST_RTP_HDREXT_ELEMENT_CLASS,
+                                          "Absolute Capture Time RTP Header Extension",
+                                          "mojyack <mojyack@gmail.com>");
+}
+
+auto abs_capture_time_meta_caps() -> GstCaps* {
+    static const auto caps = gst_static_caps_get(&meta_caps);
+    return caps;
+}
+
+auto abs_capture_latency_meta_caps() -> GstCaps* {
+    static const auto caps = gst_static_caps_get(&latency_meta_caps);
+    return caps;
+}
+
+auto abs_capture_time_now() -> GstClockTime {
+    return guint64(g_get_real_time()) * GST_USECOND + ntp_unix_epoch_diff * GST_SECOND;
+}
+
+auto abs_capture_time_extension_new() -> GstRTPHeaderExtension* {
+    return GST_RTP_HEADER_EXTENSION(g_object_new(GST_TYPE_RTP_HEADER_EXTENSION_ABS_CAPTURE_TIME, NULL));
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <gst/rtp/gstrtphdrext.h>
+
+constexpr auto rtp_hdrext_abs_capture_time_uri = "http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time";
+
+// caps of the GstReferenceTimestampMeta which carries capture time
+// timestamps are nanoseconds since the NTP epoch, the returned caps is not owned by the caller
+auto abs_capture_time_meta_caps() -> GstCaps*;
+
+// caps of the GstReferenceTimestampMeta which carries capture-to-output latency on received buffers
+// the timestamp field is the latency in nanoseconds, the returned caps is not owned by the caller
+auto abs_capture_latency_meta_caps() -> GstCaps*;
+
+// current wall clock time in the same format
+auto abs_capture_time_now() -> GstClockTime;
+
+auto abs_capture_time_extension_new() -> GstRTPHeaderExtension*;
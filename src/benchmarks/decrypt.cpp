@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <print>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "../decrypt-workers.hpp"
+#include "../gstutil/auto-gst-object.hpp"
+#include "../gstutil/pipeline-helper.hpp"
+#include "../macros/autoptr.hpp"
+#include "../macros/unwrap.hpp"
+#include "../util/charconv.hpp"
+
+// receive side srtp throughput, dtlssrtpdec alone against dtlssrtpdec with decrypt workers
+// a dtls loopback keys both ends, the encrypted packets are captured once and replayed into the receiver
+namespace {
+declare_autoptr(GstCaps, GstCaps, gst_caps_unref);
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ssrcs        = 32;
+constexpr auto payload_size = 1200;
+
+struct Context {
+    GstElement*             pipeline;
+    GstElement*             client_enc; // sender
+    GstElement*             server_dec; // receiver under measurement
+    DecryptWorkers          decrypt_workers;
+    std::atomic_bool        keyed    = false;
+    std::atomic_int         captured = 0;
+    std::atomic_int         received = 0;
+    std::vector<GstBuffer*> packets; // encrypted, owned
+};
+
+auto client_enc_on_key_set_handler(GstElement* const /*enc*/, const gpointer data) -> void {
+    auto& self = *std::bit_cast<Context*>(data);
+    self.keyed = true;
+}
+
+// keeps encrypted rtp away from the receiver, dtls goes through
+auto capture_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      self   = *std::bit_cast<Context*>(data);
+    const auto buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    auto       header = std::array<guint8, 2>();
+    if(gst_buffer_extract(buffer, 0, header.data(), header.size()) != header.size() || header[0] < 128 || header[0] > 191) {
+        return GST_PAD_PROBE_OK;
+    }
+    self.packets.push_back(gst_buffer_ref(buffer));
+    self.captured += 1;
+    return GST_PAD_PROBE_DROP;
+}
+
+auto count_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<Context*>(data);
+    if(info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        self.received += gst_buffer_list_length(GST_PAD_PROBE_INFO_BUFFER_LIST(info));
+    } else {
+        self.received += 1;
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+auto wait_for(auto&& cond, const std::chrono::seconds timeout) -> bool {
+    const auto deadline = Clock::now() + timeout;
+    while(!cond()) {
+        if(Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// same topology as construct_sub_pipeline(), except that appsrc blocks instead of leaking so that every packet is counted
+auto setup_receiver(Context& self, const guint workers) -> bool {
+    unwrap_mut(fakesink, add_new_element_to_pipeine(self.pipeline, "fakesink"));
+    g_object_set(&fakesink,
+                 "sync", FALSE,
+                 "async", FALSE,
+                 NULL);
+    const auto fakesink_sink_pad = AutoGstObject(gst_element_get_static_pad(&fakesink, "sink"));
+    ensure(fakesink_sink_pad.get() != NULL);
+    gst_pad_add_probe(fakesink_sink_pad.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), count_probe, &self, NULL);
+    if(workers == 0) {
+        ensure(gst_element_link_pads(self.server_dec, "rtp_src", &fakesink, NULL) == TRUE);
+        return true;
+    }
+
+    unwrap_mut(funnel, add_new_element_to_pipeine(self.pipeline, "funnel"));
+    ensure(gst_element_link_pads(self.server_dec, "rtp_src", &funnel, NULL) == TRUE);
+    ensure(gst_element_link(&funnel, &fakesink) == TRUE);
+    const auto srtp_caps = AutoGstCaps(gst_caps_new_empty_simple("application/x-srtp"));
+    for(auto i = 0u; i < workers; i += 1) {
+        unwrap_mut(appsrc, add_new_element_to_pipeine(self.pipeline, "appsrc"));
+        g_object_set(&appsrc,
+                     "caps", srtp_caps.get(),
+                     "format", GST_FORMAT_TIME,
+                     "is-live", TRUE,
+                     "block", TRUE,
+                     NULL);
+        unwrap_mut(srtpdec, add_new_element_to_pipeine(self.pipeline, "srtpdec"));
+        ensure(gst_element_link_pads(&appsrc, NULL, &srtpdec, "rtp_sink") == TRUE);
+        ensure(gst_element_link_pads(&srtpdec, "rtp_src", &funnel, NULL) == TRUE);
+        self.decrypt_workers.add_worker(&appsrc, &srtpdec);
+    }
+    ensure(self.decrypt_workers.install(self.server_dec));
+    return true;
+}
+
+auto push_rtp(GstElement* const appsrc, const int count) -> bool {
+    for(auto i = 0; i < count; i += 1) {
+        const auto buffer = gst_rtp_buffer_new_allocate(payload_size, 0, 0);
+        ensure(buffer != NULL);
+        auto rtp = GstRTPBuffer(GST_RTP_BUFFER_INIT);
+        ensure(gst_rtp_buffer_map(buffer, GST_MAP_WRITE, &rtp) == TRUE);
+        gst_rtp_buffer_set_ssrc(&rtp, 0x10000 + i % ssrcs);
+        gst_rtp_buffer_set_seq(&rtp, guint16(i / ssrcs));
+        gst_rtp_buffer_set_timestamp(&rtp, guint32(i / ssrcs) * 3000);
+        gst_rtp_buffer_set_payload_type(&rtp, 96);
+        gst_rtp_buffer_unmap(&rtp);
+        ensure(gst_app_src_push_buffer(GST_APP_SRC(appsrc), buffer) == GST_FLOW_OK);
+    }
+    return true;
+}
+
+auto run(const guint workers, const int count) -> bool {
+    auto error    = (GError*)(nullptr);
+    auto pipeline = AutoGstObject(gst_parse_launch(
+        "appsrc name=rtp_src caps=application/x-rtp format=time is-live=true ! client_enc.rtp_sink_0 "
+        "dtlssrtpenc name=client_enc connection-id=client is-client=true ! dtlssrtpdec name=server_dec connection-id=server "
+        "dtlssrtpenc name=server_enc connection-id=server is-client=false ! dtlssrtpdec name=client_dec connection-id=client "
+        "client_dec.rtp_src ! fakesink sync=false async=false",
+        &error));
+    ensure(pipeline.get() != NULL, "failed to create pipeline: {}", error != NULL ? error->message : "");
+
+    auto self          = Context();
+    self.pipeline      = pipeline.get();
+    self.client_enc    = gst_bin_get_by_name(GST_BIN(pipeline.get()), "client_enc");
+    self.server_dec    = gst_bin_get_by_name(GST_BIN(pipeline.get()), "server_dec");
+    const auto rtp_src = AutoGstObject(gst_bin_get_by_name(GST_BIN(pipeline.get()), "rtp_src"));
+    ensure(self.client_enc != NULL && self.server_dec != NULL && rtp_src.get() != NULL);
+    const auto client_enc = AutoGstObject(self.client_enc);
+    const auto server_dec = AutoGstObject(self.server_dec);
+
+    g_signal_connect(self.client_enc, "on-key-set", G_CALLBACK(client_enc_on_key_set_handler), &self);
+    const auto enc_src_pad = AutoGstObject(gst_element_get_static_pad(self.client_enc, "src"));
+    ensure(enc_src_pad.get() != NULL);
+    const auto capture = gst_pad_add_probe(enc_src_pad.get(), GST_PAD_PROBE_TYPE_BUFFER, capture_probe, &self, NULL);
+    ensure(setup_receiver(self, workers));
+
+    ensure(gst_element_set_state(pipeline.get(), GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+    ensure(wait_for([&self] { return self.keyed.load(); }, std::chrono::seconds(10)), "dtls handshake timed out");
+    ensure(push_rtp(rtp_src.get(), count));
+    ensure(wait_for([&self, count] { return self.captured.load() == count; }, std::chrono::seconds(10)), "encryption timed out");
+    gst_pad_remove_probe(enc_src_pad.get(), capture);
+
+    // the receiver is fed from this thread like nicesrc feeds it from its own
+    const auto dec_sink_pad = AutoGstObject(gst_element_get_static_pad(self.server_dec, "sink"));
+    ensure(dec_sink_pad.get() != NULL);
+    const auto begin = Clock::now();
+    for(const auto buffer : std::exchange(self.packets, {})) {
+        ensure(gst_pad_chain(dec_sink_pad.get(), buffer) == GST_FLOW_OK);
+    }
+    const auto done = wait_for([&self, count] { return self.received.load() >= count; }, std::chrono::seconds(30));
+    const auto time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin);
+    gst_element_set_state(pipeline.get(), GST_STATE_NULL);
+    ensure(done, "decrypted {} of {} packets", self.received.load(), count);
+
+    std::println("workers={:<3} packets={} time={}us rate={:.0f}packets/s",
+                 workers, count, time.count(), double(count) / (double(time.count()) / 1e6));
+    return true;
+}
+} // namespace
+
+// usage: decrypt-benchmark [PACKETS]
+auto main(const int argc, const char* const* argv) -> int {
+    auto count = 200000;
+    if(argc >= 2) {
+        unwrap(value, from_chars<int>(argv[1]), "invalid packets");
+        count = value;
+    }
+
+    gst_init(NULL, NULL);
+    const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for(const auto workers : {0u, 1u, 2u, 4u, cores}) {
+        ensure(run(workers, count), "run failed");
+    }
+    return 0;
+}
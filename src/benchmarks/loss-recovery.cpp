@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+#include <gst/rtp/gstrtpdefs.h>
+
+#include "../gstutil/auto-gst-object.hpp"
+#include "../gstutil/pipeline-helper.hpp"
+#include "../macros/autoptr.hpp"
+#include "../macros/unwrap.hpp"
+#include "../util/charconv.hpp"
+
+// video rtx recovery under fixed netsim profiles, and a gate on its results
+// sender rtpbin with rtprtxsend -> netsim -> receiver rtpbin with rtprtxreceive, configured like jitsibin's.
+// rtcp is exchanged unimpaired in both directions so that nacks reach the sender.
+namespace {
+declare_autoptr(GstCaps, GstCaps, gst_caps_unref);
+declare_autoptr(GstStructure, GstStructure, gst_structure_free);
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ssrc         = 0x10000u;
+constexpr auto rtx_ssrc     = 0x20000u;
+constexpr auto pt           = 96;
+constexpr auto rtx_pt       = 97;
+constexpr auto payload_size = 1200;
+constexpr auto interval     = std::chrono::milliseconds(1);
+constexpr auto jb_latency   = 200; // jitterbuffer-latency default
+
+struct Profile {
+    const char*               name;
+    const char*               netsim;
+    double                    max_loss;         // after retransmission
+    double                    max_rtx_overhead; // retransmitted / sent
+    std::chrono::milliseconds max_latency;      // 99th percentile, push to receiver output
+};
+
+constexpr auto profiles = std::array{
+    Profile{"clean", "netsim", 0.0, 0.01, std::chrono::milliseconds(20)},
+    Profile{"loss-2", "netsim drop-probability=0.02", 0.002, 0.05, std::chrono::milliseconds(100)},
+    Profile{"loss-5-jitter", "netsim drop-probability=0.05 delay-probability=1.0 min-delay=5 max-delay=30", 0.005, 0.12, std::chrono::milliseconds(200)},
+};
+
+struct Context {
+    GstElement*                    pipeline;
+    GstElement*                    jitterbuffer = nullptr; // referenced
+    std::vector<Clock::time_point> pushed;                 // indexed by seq
+    std::vector<Clock::duration>   latencies;              // written by the receiver streaming thread
+    std::atomic_int                received = 0;
+};
+
+struct Result {
+    guint64                   pushed;
+    guint64                   lost;
+    guint64                   rtx_requests;
+    guint                     rtx_packets;
+    std::chrono::microseconds median_latency;
+    std::chrono::microseconds p99_latency;
+    std::chrono::microseconds rtx_rtt;
+    double                    loss;
+    double                    rtx_overhead;
+};
+
+auto sender_request_aux_sender_handler(GstElement* const /*rtpbin*/, const guint session, gpointer const /*data*/) -> GstElement* {
+    const auto pt_map   = AutoGstStructure(gst_structure_new("application/x-rtp-pt-map",
+                                                             std::to_string(pt).data(), G_TYPE_UINT, rtx_pt,
+                                                             NULL));
+    const auto ssrc_map = AutoGstStructure(gst_structure_new("application/x-rtp-ssrc-map",
+                                                             std::to_string(ssrc).data(), G_TYPE_INT, rtx_ssrc,
+                                                             NULL));
+    const auto rtprtxsend = gst_element_factory_make("rtprtxsend", "rtprtxsend");
+    g_object_set(rtprtxsend,
+                 "payload-type-map", pt_map.get(),
+                 "ssrc-map", ssrc_map.get(),
+                 "max-size-packets", 100, // rtx-history-packets default
+                 NULL);
+    const auto bin = gst_bin_new(NULL);
+    gst_bin_add(GST_BIN(bin), rtprtxsend);
+    for(const auto name : {"src", "sink"}) {
+        const auto target = AutoGstObject(gst_element_get_static_pad(rtprtxsend, name));
+        gst_element_add_pad(bin, gst_ghost_pad_new(std::format("{}_{}", name, session).data(), target.get()));
+    }
+    return bin;
+}
+
+auto receiver_request_aux_receiver_handler(GstElement* const /*rtpbin*/, const guint session, gpointer const /*data*/) -> GstElement* {
+    const auto pt_map = AutoGstStructure(gst_structure_new("application/x-rtp-pt-map",
+                                                           std::to_string(pt).data(), G_TYPE_UINT, rtx_pt,
+                                                           NULL));
+    const auto rtprtxreceive = gst_element_factory_make("rtprtxreceive", NULL);
+    g_object_set(rtprtxreceive,
+                 "payload-type-map", pt_map.get(),
+                 NULL);
+    const auto bin = gst_bin_new(NULL);
+    gst_bin_add(GST_BIN(bin), rtprtxreceive);
+    for(const auto name : {"src", "sink"}) {
+        const auto target = AutoGstObject(gst_element_get_static_pad(rtprtxreceive, name));
+        gst_element_add_pad(bin, gst_ghost_pad_new(std::format("{}_{}", name, session).data(), target.get()));
+    }
+    return bin;
+}
+
+auto receiver_request_pt_map_handler(GstElement* const /*rtpbin*/, const guint /*session*/, const guint pt, gpointer const /*data*/) -> GstCaps* {
+    return gst_caps_new_simple("application/x-rtp",
+                               "media", G_TYPE_STRING, "video",
+                               "encoding-name", G_TYPE_STRING, "VP8",
+                               "clock-rate", G_TYPE_INT, 90000,
+                               "payload", G_TYPE_INT, pt,
+                               NULL);
+}
+
+// same settings as jitsibin's for video
+auto receiver_new_jitterbuffer_handler(GstElement* const /*rtpbin*/, GstElement* const jitterbuffer, const guint /*session*/, const guint /*ssrc*/, gpointer const data) -> void {
+    auto& self = *std::bit_cast<Context*>(data);
+    g_object_set(jitterbuffer,
+                 "do-retransmission", TRUE,
+                 "drop-on-latency", TRUE,
+                 "latency", jb_latency,
+                 NULL);
+    self.jitterbuffer = GST_ELEMENT(gst_object_ref(jitterbuffer));
+}
+
+auto output_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      self   = *std::bit_cast<Context*>(data);
+    const auto buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    auto       rtp    = GstRTPBuffer(GST_RTP_BUFFER_INIT);
+    if(gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp) == FALSE) {
+        return GST_PAD_PROBE_OK;
+    }
+    const auto seq = gst_rtp_buffer_get_seq(&rtp);
+    gst_rtp_buffer_unmap(&rtp);
+    if(seq < self.pushed.size()) {
+        self.latencies.push_back(Clock::now() - self.pushed[seq]);
+        self.received += 1;
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+auto receiver_pad_added_handler(GstElement* const /*rtpbin*/, GstPad* const pad, gpointer const data) -> void {
+    auto& self = *std::bit_cast<Context*>(data);
+    if(!std::string_view(GST_PAD_NAME(pad)).starts_with("recv_rtp_src_")) {
+        return;
+    }
+    const auto fakesink = gst_element_factory_make("fakesink", NULL);
+    g_object_set(fakesink,
+                 "sync", FALSE,
+                 "async", FALSE,
+                 NULL);
+    gst_bin_add(GST_BIN(self.pipeline), fakesink);
+    const auto sink_pad = AutoGstObject(gst_element_get_static_pad(fakesink, "sink"));
+    gst_pad_add_probe(sink_pad.get(), GST_PAD_PROBE_TYPE_BUFFER, output_probe, &self, NULL);
+    gst_pad_link(pad, sink_pad.get());
+    gst_element_sync_state_with_parent(fakesink);
+}
+
+auto push_rtp(GstElement* const appsrc, Context& self, const int count) -> bool {
+    auto next = Clock::now();
+    for(auto i = 0; i < count; i += 1) {
+        const auto buffer = gst_rtp_buffer_new_allocate(payload_size, 0, 0);
+        ensure(buffer != NULL);
+        auto rtp = GstRTPBuffer(GST_RTP_BUFFER_INIT);
+        ensure(gst_rtp_buffer_map(buffer, GST_MAP_WRITE, &rtp) == TRUE);
+        gst_rtp_buffer_set_ssrc(&rtp, ssrc);
+        gst_rtp_buffer_set_seq(&rtp, guint16(i));
+        gst_rtp_buffer_set_timestamp(&rtp, guint32(i) * 90);
+        gst_rtp_buffer_set_payload_type(&rtp, pt);
+        gst_rtp_buffer_unmap(&rtp);
+        std::this_thread::sleep_until(next);
+        next += interval;
+        self.pushed[i] = Clock::now();
+        ensure(gst_app_src_push_buffer(GST_APP_SRC(appsrc), buffer) == GST_FLOW_OK);
+    }
+    return true;
+}
+
+auto run(const Profile& profile, const int count) -> std::optional<Result> {
+    const auto pipeline = AutoGstObject(gst_pipeline_new(NULL));
+    ensure(pipeline.get() != NULL);
+    auto self     = Context();
+    self.pipeline = pipeline.get();
+    self.pushed.resize(count);
+    self.latencies.reserve(count);
+
+    unwrap_mut(appsrc, add_new_element_to_pipeine(pipeline.get(), "appsrc"));
+    const auto caps = AutoGstCaps(gst_caps_new_simple("application/x-rtp",
+                                                      "media", G_TYPE_STRING, "video",
+                                                      "encoding-name", G_TYPE_STRING, "VP8",
+                                                      "clock-rate", G_TYPE_INT, 90000,
+                                                      "payload", G_TYPE_INT, pt,
+                                                      NULL));
+    g_object_set(&appsrc,
+                 "caps", caps.get(),
+                 "format", GST_FORMAT_TIME,
+                 "is-live", TRUE,
+                 "do-timestamp", TRUE,
+                 NULL);
+
+    unwrap_mut(sender, add_new_element_to_pipeine(pipeline.get(), "rtpbin"));
+    g_object_set(&sender,
+                 "rtp-profile", GST_RTP_PROFILE_AVPF,
+                 NULL);
+    g_signal_connect(&sender, "request-aux-sender", G_CALLBACK(sender_request_aux_sender_handler), NULL);
+
+    auto       error  = (GError*)(nullptr);
+    const auto netsim = gst_parse_launch(profile.netsim, &error);
+    ensure(netsim != NULL, "failed to create netsim: {}", error != NULL ? error->message : "");
+    ensure(gst_bin_add(GST_BIN(pipeline.get()), netsim) == TRUE);
+
+    unwrap_mut(receiver, add_new_element_to_pipeine(pipeline.get(), "rtpbin"));
+    g_object_set(&receiver,
+                 "rtp-profile", GST_RTP_PROFILE_AVPF,
+                 "do-lost", TRUE,
+                 NULL);
+    g_signal_connect(&receiver, "request-aux-receiver", G_CALLBACK(receiver_request_aux_receiver_handler), NULL);
+    g_signal_connect(&receiver, "request-pt-map", G_CALLBACK(receiver_request_pt_map_handler), NULL);
+    g_signal_connect(&receiver, "new-jitterbuffer", G_CALLBACK(receiver_new_jitterbuffer_handler), &self);
+    g_signal_connect(&receiver, "pad-added", G_CALLBACK(receiver_pad_added_handler), &self);
+
+    ensure(gst_element_link_pads(&appsrc, NULL, &sender, "send_rtp_sink_0") == TRUE);
+    ensure(gst_element_link_pads(&sender, "send_rtp_src_0", netsim, NULL) == TRUE);
+    ensure(gst_element_link_pads(netsim, NULL, &receiver, "recv_rtp_sink_0") == TRUE);
+    ensure(gst_element_link_pads(&sender, "send_rtcp_src_0", &receiver, "recv_rtcp_sink_0") == TRUE);
+    ensure(gst_element_link_pads(&receiver, "send_rtcp_src_0", &sender, "recv_rtcp_sink_0") == TRUE);
+
+    ensure(gst_element_set_state(pipeline.get(), GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+    ensure(push_rtp(&appsrc, self, count));
+    // let the jitterbuffer give up on the last gaps
+    std::this_thread::sleep_for(std::chrono::milliseconds(jb_latency * 2));
+
+    const auto rtprtxsend = AutoGstObject(gst_bin_get_by_name(GST_BIN(&sender), "rtprtxsend"));
+    ensure(rtprtxsend.get() != NULL);
+    auto rtx_packets = guint();
+    g_object_get(rtprtxsend.get(), "num-rtx-packets", &rtx_packets, NULL);
+    ensure(self.jitterbuffer != nullptr, "no stream received");
+    const auto jitterbuffer = AutoGstObject(self.jitterbuffer);
+    auto       stats_ptr    = (GstStructure*)(nullptr);
+    g_object_get(jitterbuffer.get(), "stats", &stats_ptr, NULL);
+    const auto stats = AutoGstStructure(stats_ptr);
+    gst_element_set_state(pipeline.get(), GST_STATE_NULL);
+    ensure(stats.get() != NULL);
+
+    auto ret = Result();
+    ensure(gst_structure_get_uint64(stats.get(), "num-pushed", &ret.pushed) == TRUE);
+    ensure(gst_structure_get_uint64(stats.get(), "num-lost", &ret.lost) == TRUE);
+    ensure(gst_structure_get_uint64(stats.get(), "rtx-count", &ret.rtx_requests) == TRUE);
+    auto rtx_rtt = guint64();
+    ensure(gst_structure_get_uint64(stats.get(), "rtx-rtt", &rtx_rtt) == TRUE);
+    // lost packets at the tail are not detected by the jitterbuffer
+    ret.lost         = std::max(ret.lost, guint64(count - self.received.load()));
+    ret.rtx_packets  = rtx_packets;
+    ret.rtx_rtt      = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(rtx_rtt));
+    ret.loss         = double(ret.lost) / count;
+    ret.rtx_overhead = double(rtx_packets) / count;
+    ensure(!self.latencies.empty(), "no packets received");
+    std::ranges::sort(self.latencies);
+    const auto to_us   = [](const Clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d); };
+    ret.median_latency = to_us(self.latencies[self.latencies.size() / 2]);
+    ret.p99_latency    = to_us(self.latencies[self.latencies.size() * 99 / 100]);
+    return ret;
+}
+} // namespace
+
+// usage: loss-recovery-benchmark [PACKETS]
+// exits with 1 if a profile crosses one of its thresholds
+auto main(const int argc, const char* const* argv) -> int {
+    constexpr auto error_value = 1;
+
+    auto count = 5000;
+    if(argc >= 2) {
+        unwrap(value, from_chars<int>(argv[1]), "invalid packets");
+        count = value;
+    }
+    ensure_v(count > 0 && count <= 65536, "packets must be in 1..65536");
+
+    gst_init(NULL, NULL);
+    auto passed = true;
+    for(const auto& profile : profiles) {
+        const auto result = run(profile, count);
+        ensure_v(result, "run failed");
+        std::println("{:<14} pushed={:<6} lost={:<4} loss={:.4f} rtx-requests={:<5} rtx-packets={:<5} rtx-overhead={:.4f} rtx-rtt={}us latency-median={}us latency-p99={}us",
+                     profile.name, result->pushed, result->lost, result->loss, result->rtx_requests, result->rtx_packets, result->rtx_overhead,
+                     result->rtx_rtt.count(), result->median_latency.count(), result->p99_latency.count());
+        if(result->loss > profile.max_loss) {
+            std::println("{}: loss {:.4f} exceeds {:.4f}", profile.name, result->loss, profile.max_loss);
+            passed = false;
+        }
+        if(result->rtx_overhead > profile.max_rtx_overhead) {
+            std::println("{}: rtx overhead {:.4f} exceeds {:.4f}", profile.name, result->rtx_overhead, profile.max_rtx_overhead);
+            passed = false;
+        }
+        if(result->p99_latency > profile.max_latency) {
+            std::println("{}: latency {}us exceeds {}us", profile.name, result->p99_latency.count(),
+                         std::chrono::duration_cast<std::chrono::microseconds>(profile.max_latency).count());
+            passed = false;
+        }
+    }
+    return passed ? 0 : error_value;
+}
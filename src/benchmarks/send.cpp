@@ -0,0 +1,200 @@
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <print>
+#include <thread>
+
+#include <time.h>
+
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+#include <gst/rtp/gstrtpdefs.h>
+
+#include "../gstutil/auto-gst-object.hpp"
+#include "../gstutil/pipeline-helper.hpp"
+#include "../macros/unwrap.hpp"
+#include "../pacer.hpp"
+#include "../util/charconv.hpp"
+
+// send side throughput, appsrc -> (pacer) -> rtpbin -> dtlssrtpenc, with frames pushed as buffer lists or one buffer at a time
+// a dtls loopback keys the encoder, encrypted rtp is counted and dropped at its src pad in place of nicesink
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ssrc              = 0x10000u;
+constexpr auto payload_size      = 1200;
+constexpr auto packets_per_frame = 32; // a keyframe at a few Mbps, as rtph264pay would push it
+
+struct Mode {
+    const char* name;
+    bool        lists;
+    guint64     pacing_rate; // bits per second, 0 for no pacer
+};
+
+constexpr auto modes = std::array{
+    Mode{"buffers", false, 0},
+    Mode{"lists", true, 0},
+    Mode{"buffers-pacer", false, 500'000'000},
+    Mode{"lists-pacer", true, 500'000'000},
+};
+
+struct Context {
+    Pacer            pacer;
+    std::atomic_bool keyed   = false;
+    std::atomic_int  sent    = 0; // encrypted rtp packets
+    std::atomic_int  batches = 0; // pushes reaching the sink
+};
+
+auto client_enc_on_key_set_handler(GstElement* const /*enc*/, const gpointer data) -> void {
+    auto& self = *std::bit_cast<Context*>(data);
+    self.keyed = true;
+}
+
+auto is_rtp(GstBuffer* const buffer) -> bool {
+    auto header = std::array<guint8, 2>();
+    return gst_buffer_extract(buffer, 0, header.data(), header.size()) == header.size() && header[0] >= 128 && header[0] <= 191;
+}
+
+// stands in for nicesink, dtls goes through to the peer
+auto sink_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<Context*>(data);
+    if(info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        const auto list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+        if(gst_buffer_list_length(list) == 0 || !is_rtp(gst_buffer_list_get(list, 0))) {
+            return GST_PAD_PROBE_OK;
+        }
+        self.sent += gst_buffer_list_length(list);
+    } else {
+        if(!is_rtp(GST_PAD_PROBE_INFO_BUFFER(info))) {
+            return GST_PAD_PROBE_OK;
+        }
+        self.sent += 1;
+    }
+    self.batches += 1;
+    return GST_PAD_PROBE_DROP;
+}
+
+auto wait_for(auto&& cond, const std::chrono::seconds timeout) -> bool {
+    const auto deadline = Clock::now() + timeout;
+    while(!cond()) {
+        if(Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+auto get_cpu_time() -> std::chrono::nanoseconds {
+    auto ts = timespec();
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+auto create_packet(const int index) -> GstBuffer* {
+    const auto buffer = gst_rtp_buffer_new_allocate(payload_size, 0, 0);
+    auto       rtp    = GstRTPBuffer(GST_RTP_BUFFER_INIT);
+    gst_rtp_buffer_map(buffer, GST_MAP_WRITE, &rtp);
+    gst_rtp_buffer_set_ssrc(&rtp, ssrc);
+    gst_rtp_buffer_set_seq(&rtp, guint16(index));
+    gst_rtp_buffer_set_timestamp(&rtp, guint32(index / packets_per_frame) * 3000);
+    gst_rtp_buffer_set_payload_type(&rtp, 96);
+    gst_rtp_buffer_set_marker(&rtp, (index + 1) % packets_per_frame == 0);
+    gst_rtp_buffer_unmap(&rtp);
+    return buffer;
+}
+
+auto push_frames(GstElement* const appsrc, const bool lists, const int count) -> bool {
+    for(auto i = 0; i < count; i += packets_per_frame) {
+        if(lists) {
+            const auto list = gst_buffer_list_new_sized(packets_per_frame);
+            for(auto j = i; j < i + packets_per_frame; j += 1) {
+                gst_buffer_list_add(list, create_packet(j));
+            }
+            ensure(gst_app_src_push_buffer_list(GST_APP_SRC(appsrc), list) == GST_FLOW_OK);
+        } else {
+            for(auto j = i; j < i + packets_per_frame; j += 1) {
+                ensure(gst_app_src_push_buffer(GST_APP_SRC(appsrc), create_packet(j)) == GST_FLOW_OK);
+            }
+        }
+    }
+    return true;
+}
+
+auto run(const Mode& mode, const int count) -> bool {
+    auto error    = (GError*)(nullptr);
+    auto pipeline = AutoGstObject(gst_parse_launch(
+        "appsrc name=rtp_src format=time is-live=true block=true "
+        "caps=application/x-rtp,media=video,clock-rate=90000,encoding-name=H264,payload=96 "
+        "rtpbin name=rtpbin rtp-profile=savpf "
+        "dtlssrtpenc name=client_enc connection-id=client is-client=true ! dtlssrtpdec name=server_dec connection-id=server "
+        "dtlssrtpenc name=server_enc connection-id=server is-client=false ! dtlssrtpdec name=client_dec connection-id=client "
+        "server_dec.rtp_src ! fakesink sync=false async=false "
+        "client_dec.rtp_src ! fakesink sync=false async=false",
+        &error));
+    ensure(pipeline.get() != NULL, "failed to create pipeline: {}", error != NULL ? error->message : "");
+
+    auto       self       = Context();
+    const auto rtp_src    = AutoGstObject(gst_bin_get_by_name(GST_BIN(pipeline.get()), "rtp_src"));
+    const auto rtpbin     = AutoGstObject(gst_bin_get_by_name(GST_BIN(pipeline.get()), "rtpbin"));
+    const auto client_enc = AutoGstObject(gst_bin_get_by_name(GST_BIN(pipeline.get()), "client_enc"));
+    ensure(rtp_src.get() != NULL && rtpbin.get() != NULL && client_enc.get() != NULL);
+
+    // same queue as construct_sub_pipeline() sets up for the video pacer
+    auto rtpbin_sink = rtp_src.get();
+    if(mode.pacing_rate > 0) {
+        unwrap_mut(queue, add_new_element_to_pipeine(pipeline.get(), "queue"));
+        g_object_set(&queue,
+                     "max-size-buffers", 0u,
+                     "max-size-bytes", 0u,
+                     "max-size-time", guint64(GST_SECOND),
+                     NULL);
+        ensure(gst_element_link(rtp_src.get(), &queue) == TRUE);
+        self.pacer.bitrate.store(mode.pacing_rate);
+        ensure(self.pacer.install(&queue));
+        rtpbin_sink = &queue;
+    }
+    ensure(gst_element_link_pads(rtpbin_sink, NULL, rtpbin.get(), "send_rtp_sink_0") == TRUE);
+    ensure(gst_element_link_pads(rtpbin.get(), "send_rtp_src_0", client_enc.get(), "rtp_sink_0") == TRUE);
+
+    g_signal_connect(client_enc.get(), "on-key-set", G_CALLBACK(client_enc_on_key_set_handler), &self);
+    const auto enc_src_pad = AutoGstObject(gst_element_get_static_pad(client_enc.get(), "src"));
+    ensure(enc_src_pad.get() != NULL);
+    gst_pad_add_probe(enc_src_pad.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), sink_probe, &self, NULL);
+
+    ensure(gst_element_set_state(pipeline.get(), GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+    ensure(wait_for([&self] { return self.keyed.load(); }, std::chrono::seconds(10)), "dtls handshake timed out");
+
+    const auto begin     = Clock::now();
+    const auto cpu_begin = get_cpu_time();
+    ensure(push_frames(rtp_src.get(), mode.lists, count));
+    const auto done = wait_for([&self, count] { return self.sent.load() >= count; }, std::chrono::seconds(60));
+    const auto time = std::chrono::duration<double>(Clock::now() - begin).count();
+    const auto cpu  = std::chrono::duration<double>(get_cpu_time() - cpu_begin).count();
+    gst_element_set_state(pipeline.get(), GST_STATE_NULL);
+    ensure(done, "sent {} of {} packets", self.sent.load(), count);
+
+    const auto mbit = double(count) * payload_size * 8 / 1e6;
+    std::println("{:<14} packets={} batches={} time={:.0f}ms rate={:.0f}packets/s throughput={:.0f}Mbps cpu={:.0f}% cpu-per-mbps={:.3f}%",
+                 mode.name, count, self.batches.load(), time * 1e3, count / time, mbit / time, cpu / time * 100, cpu / mbit * 100);
+    return true;
+}
+} // namespace
+
+// usage: send-benchmark [PACKETS]
+auto main(const int argc, const char* const* argv) -> int {
+    auto count = 200000;
+    if(argc >= 2) {
+        unwrap(value, from_chars<int>(argv[1]), "invalid packets");
+        count = value;
+    }
+    count -= count % packets_per_frame;
+
+    gst_init(NULL, NULL);
+    for(const auto& mode : modes) {
+        ensure(run(mode, count), "run failed");
+    }
+    return 0;
+}
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <new>
+#include <print>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <coop/single-event.hpp>
+
+#include "../jitsi/conference.hpp"
+#include "../jitsi/jingle-handler/jingle.hpp"
+#include "../jitsi/xmpp/negotiator.hpp"
+#include "../macros/unwrap.hpp"
+#include "../util/charconv.hpp"
+
+// count every allocation made while processing stanzas
+namespace {
+auto allocations = std::atomic<size_t>(0);
+}
+
+auto operator new(const std::size_t size) -> void* {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(const auto ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+auto operator delete(void* const ptr) noexcept -> void {
+    std::free(ptr);
+}
+
+auto operator delete(void* const ptr, const std::size_t /*size*/) noexcept -> void {
+    std::free(ptr);
+}
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto room      = "bench@conference.meet.example";
+constexpr auto our_jid   = "bench@meet.example/bench";
+constexpr auto focus_jid = "focus@auth.meet.example/focus";
+
+// synthetic stanzas shaped after what jicofo sends, each participant owns an audio and a video source
+auto build_presence(const int participant) -> std::string {
+    return std::format(R"(<presence xmlns="jabber:client" from="{}/ep{:08x}" to="{}">)"
+                       R"(<x xmlns="http://jabber.org/protocol/muc#user"><item affiliation="none" role="participant"/></x>)"
+                       R"(<nick xmlns="http://jabber.org/protocol/nick">user{}</nick>)"
+                       R"(<audiomuted>false</audiomuted><videomuted>false</videomuted>)"
+                       R"(</presence>)",
+                       room, participant, our_jid, participant);
+}
+
+auto build_sources(const int first_participant, const int participants, const bool audio) -> std::string {
+    auto ret = std::string();
+    for(auto i = first_participant; i < first_participant + participants; i += 1) {
+        const auto ssrc = uint32_t(i) * 4 + (audio ? 1 : 2);
+        ret += std::format(R"(<source xmlns="urn:xmpp:jingle:apps:rtp:ssma:0" ssrc="{}" name="ep{:08x}-{}0">)"
+                           R"(<ssrc-info xmlns="http://jitsi.org/jitmeet" owner="{}/ep{:08x}"/>)"
+                           R"(</source>)",
+                           ssrc, i, audio ? 'a' : 'v', room, i);
+        if(!audio) {
+            ret += std::format(R"(<source xmlns="urn:xmpp:jingle:apps:rtp:ssma:0" ssrc="{}" name="ep{:08x}-v0">)"
+                               R"(<ssrc-info xmlns="http://jitsi.org/jitmeet" owner="{}/ep{:08x}"/>)"
+                               R"(</source>)"
+                               R"(<ssrc-group xmlns="urn:xmpp:jingle:apps:rtp:ssma:0" semantics="FID">)"
+                               R"(<source ssrc="{}"/><source ssrc="{}"/>)"
+                               R"(</ssrc-group>)",
+                               ssrc + 1, i, room, i, ssrc, ssrc + 1);
+        }
+    }
+    return ret;
+}
+
+auto build_jingle(const std::string_view action, const int first_participant, const int participants, const int id) -> std::string {
+    constexpr auto transport = R"(<transport xmlns="urn:xmpp:jingle:transports:ice-udp:1" ufrag="bench" pwd="benchbenchbenchbenchbe">)"
+                               R"(<fingerprint xmlns="urn:xmpp:jingle:apps:dtls:0" hash="sha-256" setup="actpass">)"
+                               R"(00:11:22:33:44:55:66:77:88:99:AA:BB:CC:DD:EE:FF:00:11:22:33:44:55:66:77:88:99:AA:BB:CC:DD:EE:FF)"
+                               R"(</fingerprint>)"
+                               R"(<candidate component="1" foundation="1" generation="0" id="c1" ip="127.0.0.1" network="0" port="10000" priority="2130706431" protocol="udp" type="host"/>)"
+                               R"(</transport>)";
+    const auto     initiate  = action == "session-initiate";
+    return std::format(R"(<iq xmlns="jabber:client" from="{}/focus" to="{}" type="set" id="bench-{}">)"
+                       R"(<jingle xmlns="urn:xmpp:jingle:1" action="{}" initiator="{}" sid="bench">)"
+                       R"(<content creator="initiator" name="audio" senders="both">)"
+                       R"(<description xmlns="urn:xmpp:jingle:apps:rtp:1" media="audio">{}{}</description>{})"
+                       R"(</content>)"
+                       R"(<content creator="initiator" name="video" senders="both">)"
+                       R"(<description xmlns="urn:xmpp:jingle:apps:rtp:1" media="video">{}{}</description>{})"
+                       R"(</content>)"
+                       R"({})"
+                       R"(</jingle></iq>)",
+                       room, our_jid, id, action, focus_jid,
+                       initiate ? R"(<payload-type id="111" name="opus" clockrate="48000" channels="2"/>)"
+                                  R"(<rtp-hdrext xmlns="urn:xmpp:jingle:apps:rtp:rtp-hdrext:0" id="1" uri="urn:ietf:params:rtp-hdrext:ssrc-audio-level"/>)"
+                                : "",
+                       build_sources(first_participant, participants, true),
+                       initiate ? transport : "",
+                       initiate ? R"(<payload-type id="100" name="VP8" clockrate="90000"/>)"
+                                  R"(<payload-type id="96" name="rtx" clockrate="90000"><parameter name="apt" value="100"/></payload-type>)"
+                                : "",
+                       build_sources(first_participant, participants, false),
+                       initiate ? transport : "",
+                       initiate ? R"(<group xmlns="urn:xmpp:jingle:apps:grouping:0" semantics="BUNDLE"><content name="audio"/><content name="video"/></group>)" : "");
+}
+
+struct Sample {
+    std::chrono::nanoseconds time;
+    size_t                   allocations;
+};
+
+struct Result {
+    std::vector<Sample> negotiation; // all stanzas of a login
+    std::vector<Sample> open;
+    std::vector<Sample> sasl_features;
+    std::vector<Sample> sasl_success;
+    std::vector<Sample> bind_features;
+    std::vector<Sample> bind_result;
+    std::vector<Sample> iq_result;
+    std::vector<Sample> presence;
+    std::vector<Sample> initiate; // stanza processing, without the jingle handler
+    std::vector<Sample> initiate_handler;
+    std::vector<Sample> add_source;
+    std::vector<Sample> deparse;
+};
+
+auto measure(auto&& func) -> Sample {
+    const auto allocs = allocations.load();
+    const auto begin  = Clock::now();
+    func();
+    const auto end = Clock::now();
+    return {end - begin, allocations.load() - allocs};
+}
+
+auto operator+(const Sample& a, const Sample& b) -> Sample {
+    return {a.time + b.time, a.allocations + b.allocations};
+}
+
+auto operator-(const Sample& a, const Sample& b) -> Sample {
+    return {a.time - b.time, a.allocations - b.allocations};
+}
+
+struct Callbacks : public conference::ConferenceCallbacks {
+    JingleHandler* jingle_handler;
+    Result*        result;
+    size_t         jingles = 0;
+
+    auto send_payload(std::string_view /*payload*/) -> void override {
+    }
+
+    auto on_jingle(jingle::Jingle jingle) -> bool override {
+        jingles += 1;
+        result->deparse.push_back(measure([&] { ensure_v(jingle::deparse(jingle)); }));
+        switch(jingle.action) {
+        case jingle::Action::SessionInitiate: {
+            // creates the ice agent and the dtls certificate, reported apart from stanza processing
+            auto ret = false;
+            result->initiate_handler.push_back(measure([&] { ret = jingle_handler->on_initiate(std::move(jingle)); }));
+            return ret;
+        }
+        case jingle::Action::SourceAdd:
+            return jingle_handler->on_add_source(std::move(jingle));
+        default:
+            return true;
+        }
+    }
+};
+
+// fixed stanzas of an anonymous login to prosody, only iq ids are filled from the request being answered
+constexpr auto stream_open   = R"(<open xmlns="urn:ietf:params:xml:ns:xmpp-framing" from="meet.example" id="bench" version="1.0"/>)";
+constexpr auto sasl_features = R"(<stream:features xmlns:stream="http://etherx.jabber.org/streams">)"
+                               R"(<mechanisms xmlns="urn:ietf:params:xml:ns:xmpp-sasl"><mechanism>ANONYMOUS</mechanism></mechanisms>)"
+                               R"(</stream:features>)";
+constexpr auto sasl_success  = R"(<success xmlns="urn:ietf:params:xml:ns:xmpp-sasl"/>)";
+constexpr auto bind_features = R"(<stream:features xmlns:stream="http://etherx.jabber.org/streams">)"
+                               R"(<bind xmlns="urn:ietf:params:xml:ns:xmpp-bind"/>)"
+                               R"(<session xmlns="urn:ietf:params:xml:ns:xmpp-session"><optional/></session>)"
+                               R"(<sm xmlns="urn:xmpp:sm:3"/>)"
+                               R"(</stream:features>)";
+
+auto build_bind_result(const std::string_view id) -> std::string {
+    return std::format(R"(<iq xmlns="jabber:client" type="result" id="{}">)"
+                       R"(<bind xmlns="urn:ietf:params:xml:ns:xmpp-bind"><jid>{}</jid></bind>)"
+                       R"(</iq>)",
+                       id, our_jid);
+}
+
+auto build_extdisco_result(const std::string_view id) -> std::string {
+    return std::format(R"(<iq xmlns="jabber:client" type="result" id="{}" to="{}">)"
+                       R"(<services xmlns="urn:xmpp:extdisco:2">)"
+                       R"(<service type="stun" host="meet.example" port="3478" transport="udp"/>)"
+                       R"(<service type="turn" host="meet.example" port="3478" transport="udp" username="bench" password="bench" expires="2100-01-01T00:00:00Z"/>)"
+                       R"(</services>)"
+                       R"(</iq>)",
+                       id, our_jid);
+}
+
+auto build_iq_result(const std::string_view id) -> std::string {
+    return std::format(R"(<iq xmlns="jabber:client" type="result" id="{}" to="{}"/>)", id, our_jid);
+}
+
+// records what the negotiator sends, the answers are fed by run_negotiation
+struct NegotiatorCallbacks : public xmpp::NegotiatorCallbacks {
+    enum class Request {
+        Open,
+        Auth,
+        Bind,
+        Extdisco,
+        Iq,
+    };
+
+    std::vector<std::pair<Request, std::string>> requests;
+    Sample                                       sent = {}; // spent in send_payload, excluded from the stanza samples
+
+    static auto get_id(const std::string_view payload) -> std::string_view {
+        for(const auto quote : {'"', '\''}) {
+            const auto key = std::format(" id={}", quote);
+            if(const auto begin = payload.find(key); begin != payload.npos) {
+                const auto value = payload.substr(begin + key.size());
+                return value.substr(0, value.find(quote));
+            }
+        }
+        return {};
+    }
+
+    auto send_payload(const std::string_view payload) -> void override {
+        sent = sent + measure([&] {
+                   if(payload.starts_with("<open")) {
+                       requests.emplace_back(Request::Open, std::string());
+                   } else if(payload.starts_with("<auth")) {
+                       requests.emplace_back(Request::Auth, std::string());
+                   } else if(payload.find("urn:ietf:params:xml:ns:xmpp-bind") != payload.npos) {
+                       requests.emplace_back(Request::Bind, std::string(get_id(payload)));
+                   } else if(payload.find("urn:xmpp:extdisco") != payload.npos) {
+                       requests.emplace_back(Request::Extdisco, std::string(get_id(payload)));
+                   } else if(payload.starts_with("<iq")) {
+                       requests.emplace_back(Request::Iq, std::string(get_id(payload)));
+                   }
+               });
+    }
+};
+
+// sasl anonymous login, resource binding and service discovery, timed per fed stanza
+auto run_negotiation(Result& result) -> bool {
+    using Request = NegotiatorCallbacks::Request;
+
+    auto       callbacks     = NegotiatorCallbacks();
+    auto       negotiator    = std::unique_ptr<xmpp::Negotiator>();
+    auto       authenticated = false;
+    auto       done          = false;
+    auto       total         = Sample();
+    const auto feed          = [&](const std::string_view stanza, std::vector<Sample>& samples) -> bool {
+        callbacks.sent = {};
+        auto ret       = xmpp::FeedResult::Continue;
+        samples.push_back(measure([&] { ret = negotiator->feed_payload(stanza); }) - callbacks.sent);
+        total = total + samples.back();
+        ensure(ret != xmpp::FeedResult::Error, "negotiator rejected {}", stanza);
+        done = ret == xmpp::FeedResult::Done;
+        return true;
+    };
+
+    total = measure([&] {
+                negotiator = xmpp::Negotiator::create("meet.example", &callbacks);
+                negotiator->start_negotiation();
+            }) -
+            callbacks.sent;
+    while(!done && !callbacks.requests.empty()) {
+        for(const auto& [request, id] : std::exchange(callbacks.requests, {})) {
+            if(done) {
+                break;
+            }
+            switch(request) {
+            case Request::Open:
+                ensure(feed(stream_open, result.open));
+                ensure(authenticated ? feed(bind_features, result.bind_features) : feed(sasl_features, result.sasl_features));
+                break;
+            case Request::Auth:
+                authenticated = true;
+                ensure(feed(sasl_success, result.sasl_success));
+                break;
+            case Request::Bind:
+                ensure(feed(build_bind_result(id), result.bind_result));
+                break;
+            case Request::Extdisco:
+                ensure(feed(build_extdisco_result(id), result.iq_result));
+                break;
+            case Request::Iq:
+                ensure(feed(build_iq_result(id), result.iq_result));
+                break;
+            }
+        }
+    }
+    ensure(done, "negotiation did not finish");
+    result.negotiation.push_back(total);
+    return true;
+}
+
+// one conference lifetime: participants join, session-initiate with half of the sources, source-add with the rest
+auto run_round(const int sources, Result& result) -> bool {
+    const auto participants = std::max(sources / 2, 2);
+    const auto initial      = participants / 2;
+
+    auto event               = coop::SingleEvent();
+    auto jid                 = xmpp::Jid{.node = "bench", .domain = "meet.example", .resource = "bench"};
+    auto jingle_handler      = JingleHandler(CodecType::Opus, CodecType::Vp8, jid, {}, &event);
+    auto callbacks           = Callbacks();
+    callbacks.jingle_handler = &jingle_handler;
+    callbacks.result         = &result;
+    const auto conference    = conference::Conference::create(
+        conference::Config{
+               .jid              = jid,
+               .room             = "bench",
+               .nick             = "bench",
+               .video_codec_type = CodecType::Vp8,
+               .audio_muted      = true,
+               .video_muted      = true,
+        },
+        &callbacks);
+    conference->start_negotiation();
+
+    const auto presences = [participants] {
+        auto ret = std::vector<std::string>();
+        for(auto i = 0; i < participants; i += 1) {
+            ret.push_back(build_presence(i));
+        }
+        return ret;
+    }();
+    const auto initiate   = build_jingle("session-initiate", 0, initial, 0);
+    const auto add_source = build_jingle("source-add", initial, participants - initial, 1);
+
+    for(const auto& presence : presences) {
+        result.presence.push_back(measure([&] { conference->feed_payload(presence); }));
+    }
+    const auto handlers = result.initiate_handler.size();
+    const auto total    = measure([&] { conference->feed_payload(initiate); });
+    ensure(result.initiate_handler.size() == handlers + 1, "session-initiate was not handled");
+    result.initiate.push_back(total - result.initiate_handler.back());
+    result.add_source.push_back(measure([&] { conference->feed_payload(add_source); }));
+    ensure(callbacks.jingles == 2, "jingle was not handled");
+    return true;
+}
+
+auto report(const std::string_view name, const int sources, std::vector<Sample>& samples) -> void {
+    if(samples.empty()) {
+        return;
+    }
+    std::ranges::sort(samples, {}, [](const Sample& s) { return s.time; });
+    const auto median = samples[samples.size() / 2];
+    const auto worst  = samples.back();
+    std::println("{:<12} sources={:<5} stanzas={:<6} median={:>10}ns worst={:>10}ns allocs={}",
+                 name, sources, samples.size(), median.time.count(), worst.time.count(), median.allocations);
+}
+} // namespace
+
+// usage: signalling-benchmark [ROUNDS]
+auto main(const int argc, const char* const* argv) -> int {
+    auto rounds = 20;
+    if(argc >= 2) {
+        unwrap(value, from_chars<int>(argv[1]), "invalid rounds");
+        rounds = value;
+    }
+
+    {
+        auto result = Result();
+        for(auto i = 0; i < rounds; i += 1) {
+            ensure(run_negotiation(result), "negotiation failed");
+        }
+        report("negotiation", 0, result.negotiation);
+        report("open", 0, result.open);
+        report("sasl-feat", 0, result.sasl_features);
+        report("sasl-success", 0, result.sasl_success);
+        report("bind-feat", 0, result.bind_features);
+        report("bind-result", 0, result.bind_result);
+        report("iq-result", 0, result.iq_result);
+    }
+    for(const auto sources : {10, 100, 1000}) {
+        auto result = Result();
+        for(auto i = 0; i < rounds; i += 1) {
+            ensure(run_round(sources, result), "round failed");
+        }
+        report("presence", sources, result.presence);
+        report("initiate", sources, result.initiate);
+        report("initiate-hdl", sources, result.initiate_handler);
+        report("source-add", sources, result.add_source);
+        report("deparse", sources, result.deparse);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include "../gstutil/auto-gst-object.hpp"
+#include "../gstutil/pipeline-helper.hpp"
+#include "../macros/unwrap.hpp"
+#include "../task-pool.hpp"
+#include "../util/charconv.hpp"
+
+// cost of jitterbuffer threads for N received streams, with the default task pool and with jitterbuffer-pool
+// each stream is an idle rtpjitterbuffer, whose loop occupies a thread like it does in jitsibin
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Usage {
+    size_t threads;
+    size_t rss_kib;
+    size_t vm_kib; // thread stacks are reserved here even if untouched
+};
+
+auto get_usage() -> Usage {
+    auto ret    = Usage{};
+    auto status = std::ifstream("/proc/self/status");
+    for(auto line = std::string(); std::getline(status, line);) {
+        if(line.starts_with("Threads:")) {
+            ret.threads = std::stoul(line.substr(8));
+        } else if(line.starts_with("VmRSS:")) {
+            ret.rss_kib = std::stoul(line.substr(6));
+        } else if(line.starts_with("VmSize:")) {
+            ret.vm_kib = std::stoul(line.substr(7));
+        }
+    }
+    return ret;
+}
+
+// same hook as jitsibin's handle_message
+auto bus_sync_handler(GstBus* const /*bus*/, GstMessage* const message, gpointer const data) -> GstBusSyncReply {
+    const auto pool = std::bit_cast<GstTaskPool*>(data);
+    if(pool == nullptr || GST_MESSAGE_TYPE(message) != GST_MESSAGE_STREAM_STATUS) {
+        return GST_BUS_PASS;
+    }
+    auto type  = GstStreamStatusType();
+    auto owner = (GstElement*)(nullptr);
+    gst_message_parse_stream_status(message, &type, &owner);
+    const auto factory = gst_element_get_factory(owner);
+    if(type == GST_STREAM_STATUS_TYPE_CREATE && factory != NULL &&
+       std::string_view(gst_plugin_feature_get_name(factory)) == "rtpjitterbuffer") {
+        const auto object = gst_message_get_stream_status_object(message);
+        if(object != NULL && G_VALUE_HOLDS(object, GST_TYPE_TASK)) {
+            gst_task_set_pool(GST_TASK(g_value_get_object(object)), pool);
+        }
+    }
+    return GST_BUS_PASS;
+}
+
+struct Result {
+    Usage                     usage;
+    std::chrono::microseconds start_time; // all streams to PLAYING
+    std::chrono::microseconds churn_time; // one stream leaving and joining, averaged
+};
+
+auto run(const int streams, const int churns, GstTaskPool* const pool) -> std::optional<Result> {
+    const auto pipeline = AutoGstObject(gst_pipeline_new(NULL));
+    ensure(pipeline.get() != NULL);
+    const auto bus = AutoGstObject(gst_pipeline_get_bus(GST_PIPELINE(pipeline.get())));
+    gst_bus_set_sync_handler(bus.get(), bus_sync_handler, pool, NULL);
+
+    auto jitterbuffers = std::vector<GstElement*>();
+    for(auto i = 0; i < streams; i += 1) {
+        unwrap_mut(jitterbuffer, add_new_element_to_pipeine(pipeline.get(), "rtpjitterbuffer"));
+        unwrap_mut(fakesink, add_new_element_to_pipeine(pipeline.get(), "fakesink"));
+        g_object_set(&fakesink,
+                     "async", FALSE,
+                     NULL);
+        ensure(gst_element_link(&jitterbuffer, &fakesink) == TRUE);
+        jitterbuffers.push_back(&jitterbuffer);
+    }
+
+    const auto base  = get_usage();
+    const auto begin = Clock::now();
+    ensure(gst_element_set_state(pipeline.get(), GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+    ensure(gst_element_get_state(pipeline.get(), NULL, NULL, GST_CLOCK_TIME_NONE) != GST_STATE_CHANGE_FAILURE);
+    const auto started = Clock::now();
+    const auto usage   = get_usage();
+
+    // participants leaving and joining stop and start jitterbuffer loops
+    const auto churn_begin = Clock::now();
+    for(auto i = 0; i < churns; i += 1) {
+        const auto jitterbuffer = jitterbuffers[i % jitterbuffers.size()];
+        ensure(gst_element_set_state(jitterbuffer, GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+        ensure(gst_element_sync_state_with_parent(jitterbuffer) == TRUE);
+    }
+    const auto churn_end = Clock::now();
+    gst_element_set_state(pipeline.get(), GST_STATE_NULL);
+
+    const auto to_us = [](const Clock::duration d) { return std::chrono::duration_cast<std::chrono::microseconds>(d); };
+    return Result{
+        .usage = {
+            .threads = usage.threads - base.threads,
+            .rss_kib = usage.rss_kib - std::min(usage.rss_kib, base.rss_kib),
+            .vm_kib  = usage.vm_kib - std::min(usage.vm_kib, base.vm_kib),
+        },
+        .start_time = to_us(started - begin),
+        .churn_time = to_us(churn_end - churn_begin) / std::max(churns, 1),
+    };
+}
+
+auto report(const std::string_view name, const int streams, const Result& result) -> void {
+    std::println("{:<14} streams={:<4} threads={:<5} rss={:<7}KiB vm={:<9}KiB start={:>8}us churn={:>6}us",
+                 name, streams, result.usage.threads, result.usage.rss_kib, result.usage.vm_kib,
+                 result.start_time.count(), result.churn_time.count());
+}
+} // namespace
+
+// usage: task-pool-benchmark [CHURNS]
+auto main(const int argc, const char* const* argv) -> int {
+    auto churns = 200;
+    if(argc >= 2) {
+        unwrap(value, from_chars<int>(argv[1]), "invalid churns");
+        churns = value;
+    }
+
+    gst_init(NULL, NULL);
+    for(const auto streams : {16, 64, 256}) {
+        unwrap(def, run(streams, churns, nullptr));
+        report("default", streams, def);
+
+        const auto pool = gst_jitsi_task_pool_new(0);
+        unwrap(pooled, run(streams, churns, pool));
+        gst_object_unref(pool);
+        report("pool", streams, pooled);
+
+        const auto small_pool = gst_jitsi_task_pool_new(256 * 1024);
+        unwrap(small, run(streams, churns, small_pool));
+        gst_object_unref(small_pool);
+        report("pool-256KiB", streams, small);
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <format>
+
+#include "colibri-message.hpp"
+#include "jitsi/util/charconv.hpp"
+
+namespace colibri_message {
+namespace {
+auto escape(const std::string_view str) -> std::string {
+    auto ret = std::string();
+    for(const auto c : str) {
+        if(c == '"' || c == '\\') {
+            ret += '\\';
+        }
+        ret += c;
+    }
+    return ret;
+}
+
+// jitsi-meet names sources {endpoint}-{a|v}{index}, the camera is v0
+auto build_video_source_array(const std::span<const std::string_view> endpoints) -> std::string {
+    auto ret = std::string("[");
+    for(auto i = 0uz; i < endpoints.size(); i += 1) {
+        ret += std::format(R"({}"{}-v0")", i == 0 ? "" : ",", escape(endpoints[i]));
+    }
+    ret += "]";
+    return ret;
+}
+
+auto skip_spaces(std::string_view& str) -> void {
+    const auto i = str.find_first_not_of(" \t\r\n");
+    str          = i == str.npos ? std::string_view() : str.substr(i);
+}
+
+auto read_string(std::string_view& str) -> std::optional<std::string> {
+    if(!str.starts_with('"')) {
+        return std::nullopt;
+    }
+    auto ret = std::string();
+    for(auto i = 1uz; i < str.size(); i += 1) {
+        const auto c = str[i];
+        if(c == '"') {
+            str = str.substr(i + 1);
+            return ret;
+        }
+        if(c == '\\' && i + 1 < str.size()) {
+            i += 1;
+        }
+        ret += str[i];
+    }
+    return std::nullopt;
+}
+
+// skips a string, number, literal, object or array
+auto skip_value(std::string_view& str) -> bool {
+    if(str.starts_with('"')) {
+        return read_string(str).has_value();
+    }
+    if(!str.starts_with('{') && !str.starts_with('[')) {
+        const auto end = str.find_first_of(",}] \t\r\n");
+        if(end == 0 || end == str.npos) {
+            return false;
+        }
+        str = str.substr(end);
+        return true;
+    }
+    auto depth = 0;
+    while(!str.empty()) {
+        if(str.starts_with('"')) {
+            if(!read_string(str)) {
+                return false;
+            }
+            continue;
+        }
+        const auto c = str[0];
+        str          = str.substr(1);
+        if(c == '{' || c == '[') {
+            depth += 1;
+        } else if(c == '}' || c == ']') {
+            depth -= 1;
+            if(depth == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// returns the text of the value of a top-level member
+auto find_value(std::string_view message, const std::string_view key) -> std::optional<std::string_view> {
+    skip_spaces(message);
+    if(!message.starts_with('{')) {
+        return std::nullopt;
+    }
+    message = message.substr(1);
+    while(true) {
+        skip_spaces(message);
+        const auto name = read_string(message);
+        if(!name) {
+            return std::nullopt;
+        }
+        skip_spaces(message);
+        if(!message.starts_with(':')) {
+            return std::nullopt;
+        }
+        message = message.substr(1);
+        skip_spaces(message);
+        if(*name == key) {
+            return message;
+        }
+        if(!skip_value(message)) {
+            return std::nullopt;
+        }
+        skip_spaces(message);
+        if(!message.starts_with(',')) {
+            return std::nullopt;
+        }
+        message = message.substr(1);
+    }
+}
+} // namespace
+
+auto build(const ReceiverVideoConstraints& constraints) -> std::string {
+    return std::format(R"({{"colibriClass":"ReceiverVideoConstraints","lastN":{},"selectedSources":{},"onStageSources":{}}})",
+                       constraints.last_n,
+                       build_video_source_array(constraints.selected),
+                       build_video_source_array(constraints.on_stage));
+}
+
+auto get_class(const std::string_view message) -> std::optional<std::string> {
+    auto value = find_value(message, "colibriClass");
+    if(!value) {
+        return std::nullopt;
+    }
+    return read_string(*value);
+}
+
+auto get_string_array(const std::string_view message, const std::string_view key) -> std::optional<std::vector<std::string>> {
+    auto value = find_value(message, key);
+    if(!value || !value->starts_with('[')) {
+        return std::nullopt;
+    }
+    auto rest = value->substr(1);
+    auto ret  = std::vector<std::string>();
+    while(true) {
+        skip_spaces(rest);
+        if(rest.starts_with(']')) {
+            return ret;
+        }
+        auto str = read_string(rest);
+        if(!str) {
+            return std::nullopt;
+        }
+        ret.push_back(std::move(*str));
+        skip_spaces(rest);
+        if(rest.starts_with(',')) {
+            rest = rest.substr(1);
+        }
+    }
+}
+
+auto get_int(const std::string_view message, const std::string_view key) -> std::optional<int> {
+    const auto value = find_value(message, key);
+    if(!value) {
+        return std::nullopt;
+    }
+    const auto end = std::min(value->find_first_not_of("-0123456789"), value->size());
+    return from_chars<int>(value->substr(0, end));
+}
+
+auto get_sender_max_height(const std::string_view message) -> std::optional<int> {
+    const auto cls = get_class(message);
+    if(cls == "SenderVideoConstraints") {
+        return get_int(message, "idealHeight");
+    }
+    if(cls == "SenderSourceConstraints") {
+        return get_int(message, "maxHeight");
+    }
+    return std::nullopt;
+}
+
+auto get_forwarded_endpoints(const std::string_view message) -> std::optional<std::vector<std::string>> {
+    const auto cls = get_class(message);
+    if(cls == "LastNEndpointsChangeEvent") {
+        return get_string_array(message, "lastNEndpoints");
+    }
+    if(cls != "ForwardedSources") {
+        return std::nullopt;
+    }
+    // source names are {endpoint}-{a|v}{index}
+    auto sources = get_string_array(message, "forwardedSources");
+    if(!sources) {
+        return std::nullopt;
+    }
+    auto ret = std::vector<std::string>();
+    for(auto& source : *sources) {
+        if(const auto i = source.rfind('-'); i != source.npos) {
+            source.resize(i);
+        }
+        if(std::ranges::find(ret, source) == ret.end()) {
+            ret.push_back(std::move(source));
+        }
+    }
+    return ret;
+}
+} // namespace colibri_message
@@ -0,0 +1,29 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// builds and reads the json messages exchanged with the bridge over the colibri websocket
+// values are looked up among the top-level members of the message object
+namespace colibri_message {
+// selected and on-stage endpoints are sent as their camera sources
+struct ReceiverVideoConstraints {
+    int                               last_n;   // negative for unlimit
+    std::span<const std::string_view> selected; // endpoint ids
+    std::span<const std::string_view> on_stage;
+};
+
+auto build(const ReceiverVideoConstraints& constraints) -> std::string;
+
+// returns colibriClass of the message
+auto get_class(std::string_view message) -> std::optional<std::string>;
+auto get_string_array(std::string_view message, std::string_view key) -> std::optional<std::vector<std::string>>;
+auto get_int(std::string_view message, std::string_view key) -> std::optional<int>;
+
+// ideal height of SenderVideoConstraints or max height of SenderSourceConstraints
+auto get_sender_max_height(std::string_view message) -> std::optional<int>;
+// endpoints of ForwardedSources or LastNEndpointsChangeEvent
+auto get_forwarded_endpoints(std::string_view message) -> std::optional<std::vector<std::string>>;
+} // namespace colibri_message
@@ -0,0 +1,156 @@
+#include <array>
+#include <bit>
+#include <optional>
+#include <string_view>
+
+#include <gst/app/gstappsrc.h>
+
+#include "decrypt-workers.hpp"
+#include "gstutil/auto-gst-object.hpp"
+#include "jitsi/macros/logger.hpp"
+#include "jitsi/util/pair-table.hpp"
+
+#define CUTIL_MACROS_PRINT_FUNC(...) LOG_ERROR(logger, __VA_ARGS__)
+#include "macros/unwrap.hpp"
+
+namespace {
+auto logger = Logger("decrypt-workers");
+
+// GstDtlsSrtpCipher and GstDtlsSrtpAuth
+const auto dtls_cipher_to_srtp_cipher = make_pair_table<guint, std::string_view>({
+    {1, "aes-128-icm"},
+});
+
+const auto dtls_auth_to_srtp_auth = make_pair_table<guint, std::string_view>({
+    {1, "hmac-sha1-32"},
+    {2, "hmac-sha1-80"},
+});
+
+struct Keys {
+    GstBuffer*       key; // owned
+    std::string_view cipher;
+    std::string_view auth;
+};
+
+auto get_keys(DecryptWorkers& self) -> std::optional<Keys> {
+    auto key    = (GstBuffer*)(nullptr);
+    auto cipher = guint();
+    auto auth   = guint();
+    g_object_get(self.dtlsdec,
+                 "decoder-key", &key,
+                 "srtp-cipher", &cipher,
+                 "srtp-auth", &auth,
+                 NULL);
+    ensure(key != NULL);
+    const auto cipher_name = dtls_cipher_to_srtp_cipher.find(cipher);
+    const auto auth_name   = dtls_auth_to_srtp_auth.find(auth);
+    if(!cipher_name || !auth_name) {
+        gst_buffer_unref(key);
+        bail("unsupported srtp profile cipher={} auth={}", cipher, auth);
+    }
+    return Keys{key, *cipher_name, *auth_name};
+}
+
+auto find_child_by_factory(GstBin* const bin, const std::string_view name) -> GstElement* {
+    const auto iter  = gst_bin_iterate_recurse(bin);
+    auto       value = GValue(G_VALUE_INIT);
+    auto       found = (GstElement*)(nullptr);
+    while(found == nullptr && gst_iterator_next(iter, &value) == GST_ITERATOR_OK) {
+        const auto element = GST_ELEMENT(g_value_get_object(&value));
+        const auto factory = gst_element_get_factory(element);
+        if(factory != NULL && gst_plugin_feature_get_name(factory) == name) {
+            found = element; // owned by the bin
+        }
+        g_value_reset(&value);
+    }
+    g_value_unset(&value);
+    gst_iterator_free(iter);
+    return found;
+}
+
+auto dtlsdec_on_key_received_handler(GstElement* const /*dtlsdec*/, const gpointer data) -> void {
+    auto& self = *std::bit_cast<DecryptWorkers*>(data);
+    unwrap(keys, get_keys(self), "keep decrypting on dtlssrtpdec");
+    gst_buffer_unref(keys.key);
+    LOG_INFO(logger, "srtp keyed, dispatching to {} workers", self.workers.size());
+    self.keyed.store(true);
+}
+
+auto srtpdec_request_key_handler(GstElement* const /*srtpdec*/, const guint ssrc, const gpointer data) -> GstCaps* {
+    auto& self = *std::bit_cast<DecryptWorkers*>(data);
+    LOG_DEBUG(logger, "srtpdec request-key ssrc={}", ssrc);
+    unwrap(keys, get_keys(self));
+    const auto caps = gst_caps_new_simple("application/x-srtp",
+                                          "srtp-key", GST_TYPE_BUFFER, keys.key,
+                                          "srtp-cipher", G_TYPE_STRING, keys.cipher.data(),
+                                          "srtp-auth", G_TYPE_STRING, keys.auth.data(),
+                                          "srtcp-cipher", G_TYPE_STRING, keys.cipher.data(),
+                                          "srtcp-auth", G_TYPE_STRING, keys.auth.data(),
+                                          NULL);
+    gst_buffer_unref(keys.key);
+    return caps;
+}
+
+auto dispatch_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      self   = *std::bit_cast<DecryptWorkers*>(data);
+    const auto buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+
+    auto header = std::array<guint8, 12>();
+    if(gst_buffer_extract(buffer, 0, header.data(), header.size()) != header.size()) {
+        return GST_PAD_PROBE_OK;
+    }
+    // rfc5764 demultiplexing, and rtcp payload types from rfc5761
+    if(header[0] < 128 || header[0] > 191 || (header[1] >= 192 && header[1] <= 223)) {
+        return GST_PAD_PROBE_OK;
+    }
+    if(!self.keyed.load()) {
+        self.unkeyed_packets.fetch_add(1);
+        return GST_PAD_PROBE_OK;
+    }
+
+    const auto ssrc   = guint32(header[8]) << 24 | guint32(header[9]) << 16 | guint32(header[10]) << 8 | guint32(header[11]);
+    auto&      worker = self.workers[ssrc % self.workers.size()];
+    worker.packets.fetch_add(1);
+    gst_app_src_push_buffer(GST_APP_SRC(worker.appsrc), gst_buffer_ref(buffer));
+    return GST_PAD_PROBE_DROP;
+}
+} // namespace
+
+auto DecryptWorkers::install(GstElement* const dtlssrtpdec) -> bool {
+    ensure(!workers.empty());
+    dtlsdec = find_child_by_factory(GST_BIN(dtlssrtpdec), "dtlsdec");
+    ensure(dtlsdec != nullptr, "dtlssrtpdec has no dtlsdec");
+    g_signal_connect(dtlsdec, "on-key-received", G_CALLBACK(dtlsdec_on_key_received_handler), this);
+
+    const auto sink_pad = AutoGstObject(gst_element_get_static_pad(dtlssrtpdec, "sink"));
+    ensure(sink_pad.get() != NULL);
+    gst_pad_add_probe(sink_pad.get(), GST_PAD_PROBE_TYPE_BUFFER, dispatch_probe, this, NULL);
+    return true;
+}
+
+auto DecryptWorkers::add_worker(GstElement* const appsrc, GstElement* const srtpdec) -> void {
+    g_signal_connect(srtpdec, "request-key", G_CALLBACK(srtpdec_request_key_handler), this);
+    workers.emplace_back(appsrc);
+}
+
+auto DecryptWorkers::reset() -> void {
+    workers.clear();
+    dtlsdec = nullptr;
+    keyed.store(false);
+    unkeyed_packets.store(0);
+}
+
+auto DecryptWorkers::fill_stats(GstStructure* const stats) -> void {
+    auto packets = GValue(G_VALUE_INIT);
+    gst_value_array_init(&packets, workers.size());
+    for(const auto& worker : workers) {
+        auto value = GValue(G_VALUE_INIT);
+        g_value_init(&value, G_TYPE_UINT64);
+        g_value_set_uint64(&value, worker.packets.load());
+        gst_value_array_append_and_take_value(&packets, &value);
+    }
+    gst_structure_take_value(stats, "decrypt-worker-packets", &packets);
+    gst_structure_set(stats,
+                      "decrypt-unkeyed-packets", G_TYPE_UINT64, unkeyed_packets.load(),
+                      NULL);
+}
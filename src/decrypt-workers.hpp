@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <deque>
+
+#include <gst/gst.h>
+
+// decrypts srtp on several threads
+// keyed rtp packets are taken from dtlssrtpdec and dispatched to appsrc -> srtpdec chains by ssrc,
+// so that each ssrc keeps its order and replay window in a single srtpdec.
+// rtcp and dtls packets stay on dtlssrtpdec.
+struct DecryptWorkers {
+    struct Worker {
+        GstElement*          appsrc;
+        std::atomic<guint64> packets = 0;
+    };
+
+    std::deque<Worker>   workers;
+    GstElement*          dtlsdec         = nullptr; // inside dtlssrtpdec, holds the negotiated keys
+    std::atomic_bool     keyed           = false;
+    std::atomic<guint64> unkeyed_packets = 0; // rtp packets left to dtlssrtpdec
+
+    auto install(GstElement* dtlssrtpdec) -> bool;
+    // appsrc must be linked to srtpdec
+    auto add_worker(GstElement* appsrc, GstElement* srtpdec) -> void;
+    auto fill_stats(GstStructure* stats) -> void;
+    // forget the workers, their elements must be gone already
+    auto reset() -> void;
+};
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <gst/gst.h>
+
+#include "../gstutil/auto-gst-object.hpp"
+#include "../gstutil/pipeline-helper.hpp"
+#include "../macros/unwrap.hpp"
+#include "../util/argument-parser.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Context;
+
+struct Instance {
+    Context*                       context;
+    GstElement*                    jitsibin;
+    Clock::time_point              join_begin;
+    std::optional<Clock::duration> join_latency;      // until the state change completes, xmpp login and muc join
+    std::optional<Clock::duration> first_pad_latency; // until the first remote stream arrives
+};
+
+struct Context {
+    GstElement* pipeline;
+    GstElement* audio_tee;
+    GstElement* video_tee;
+
+    std::mutex           lock;
+    std::deque<Instance> instances; // stable addresses, passed to signal handlers
+};
+
+struct Usage {
+    std::chrono::microseconds cpu_time;
+    size_t                    rss_kib;
+    size_t                    max_rss_kib;
+    size_t                    threads;
+};
+
+auto get_usage() -> Usage {
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+    const auto to_us = [](const timeval& tv) { return std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec); };
+
+    auto ret    = Usage{.cpu_time = to_us(usage.ru_utime) + to_us(usage.ru_stime), .rss_kib = 0, .max_rss_kib = size_t(usage.ru_maxrss), .threads = 0};
+    auto status = std::ifstream("/proc/self/status");
+    for(auto line = std::string(); std::getline(status, line);) {
+        if(line.starts_with("VmRSS:")) {
+            ret.rss_kib = std::stoul(line.substr(6));
+        } else if(line.starts_with("Threads:")) {
+            ret.threads = std::stoul(line.substr(8));
+        }
+    }
+    return ret;
+}
+
+auto jitsibin_pad_added_handler(GstElement* const /*jitsibin*/, GstPad* const pad, gpointer const data) -> void {
+    auto& self = *std::bit_cast<Instance*>(data);
+    {
+        auto lock = std::lock_guard(self.context->lock);
+        if(!self.first_pad_latency) {
+            self.first_pad_latency = Clock::now() - self.join_begin;
+        }
+    }
+
+    // consume without decoding
+    unwrap_mut(fakesink, add_new_element_to_pipeine(self.context->pipeline, "fakesink"));
+    g_object_set(&fakesink,
+                 "sync", FALSE,
+                 "async", FALSE,
+                 NULL);
+    const auto sink_pad = AutoGstObject(gst_element_get_static_pad(&fakesink, "sink"));
+    ensure(sink_pad.get() != NULL);
+    ensure(gst_pad_link(pad, sink_pad.get()) == GST_PAD_LINK_OK);
+    ensure(gst_element_sync_state_with_parent(&fakesink) == TRUE);
+}
+
+auto link_tee(GstElement* const tee, GstElement* const jitsibin, const char* const sink_pad_name) -> bool {
+    const auto tee_pad = gst_element_request_pad_simple(tee, "src_%u");
+    ensure(tee_pad != NULL);
+    const auto sink_pad = AutoGstObject(gst_element_get_static_pad(jitsibin, sink_pad_name));
+    ensure(sink_pad.get() != NULL);
+    ensure(gst_pad_link(tee_pad, sink_pad.get()) == GST_PAD_LINK_OK);
+    return true;
+}
+
+// blocks until the instance has logged in and sent its muc presence
+// force-play is set since jicofo sends no session-initiate to the first participant of a room,
+// media setup is measured by the first pad instead
+auto join(Context& self, const char* const host, const int room, const int participant, const bool insecure) -> bool {
+    unwrap_mut(jitsibin, add_new_element_to_pipeine(self.pipeline, "jitsibin"));
+    const auto room_name = std::format("load-generator-{}", room);
+    const auto nick      = std::format("load-{}-{}", room, participant);
+    g_object_set(&jitsibin,
+                 "server", host,
+                 "room", room_name.data(),
+                 "nick", nick.data(),
+                 "insecure", insecure ? TRUE : FALSE,
+                 "force-play", TRUE,
+                 NULL);
+
+    auto& instance = [&self, &jitsibin]() -> Instance& {
+        auto lock = std::lock_guard(self.lock);
+        return self.instances.emplace_back(Instance{.context = &self, .jitsibin = &jitsibin, .join_begin = Clock::now()});
+    }();
+    g_signal_connect(&jitsibin, "pad-added", G_CALLBACK(jitsibin_pad_added_handler), &instance);
+    ensure(link_tee(self.audio_tee, &jitsibin, "audio_sink"));
+    ensure(link_tee(self.video_tee, &jitsibin, "video_sink"));
+
+    const auto success = gst_element_sync_state_with_parent(&jitsibin) == TRUE;
+    auto       lock    = std::lock_guard(self.lock);
+    if(success) {
+        instance.join_latency = Clock::now() - instance.join_begin;
+    }
+    return success;
+}
+
+auto percentile(const std::vector<Clock::duration>& sorted, const double p) -> std::chrono::milliseconds {
+    if(sorted.empty()) {
+        return {};
+    }
+    const auto index = std::min(size_t(double(sorted.size()) * p), sorted.size() - 1);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(sorted[index]);
+}
+
+auto report_latencies(const std::string_view name, std::vector<Clock::duration> latencies, const size_t total) -> void {
+    std::ranges::sort(latencies);
+    std::println("{:<10} n={}/{} p50={}ms p90={}ms p99={}ms max={}ms",
+                 name, latencies.size(), total,
+                 percentile(latencies, 0.5).count(),
+                 percentile(latencies, 0.9).count(),
+                 percentile(latencies, 0.99).count(),
+                 percentile(latencies, 1.0).count());
+}
+
+auto report(Context& self) -> void {
+    auto joins      = std::vector<Clock::duration>();
+    auto first_pads = std::vector<Clock::duration>();
+    auto total      = size_t();
+    {
+        auto lock = std::lock_guard(self.lock);
+        total     = self.instances.size();
+        for(const auto& instance : self.instances) {
+            if(instance.join_latency) {
+                joins.push_back(*instance.join_latency);
+            }
+            if(instance.first_pad_latency) {
+                first_pads.push_back(*instance.first_pad_latency);
+            }
+        }
+    }
+    report_latencies("join", std::move(joins), total);
+    report_latencies("first-pad", std::move(first_pads), total);
+}
+} // namespace
+
+auto main(const int argc, const char* const* argv) -> int {
+    const char* host             = nullptr;
+    auto        rooms            = 1;
+    auto        participants     = 2;
+    auto        join_interval_ms = 200;
+    auto        duration_s       = 60;
+    auto        insecure         = false;
+    {
+        auto help   = false;
+        auto parser = args::Parser<>();
+        parser.arg(&host, "HOST", "server domain");
+        parser.kwarg(&rooms, {"-r", "--rooms"}, "N", "number of rooms", {.state = args::State::DefaultValue});
+        parser.kwarg(&participants, {"-p", "--participants"}, "N", "jitsibin instances per room", {.state = args::State::DefaultValue});
+        parser.kwarg(&join_interval_ms, {"-i", "--join-interval"}, "MS", "delay between joins", {.state = args::State::DefaultValue});
+        parser.kwarg(&duration_s, {"-d", "--duration"}, "SECONDS", "time to stay after the last join", {.state = args::State::DefaultValue});
+        parser.kwflag(&insecure, {"-k", "--insecure"}, "trust self-signed certificates");
+        parser.kwflag(&help, {"-h", "--help"}, "print this help message", {.no_error_check = true});
+        if(!parser.parse(argc, argv) || help) {
+            std::println("usage: load-generator {}", parser.get_help());
+            return 0;
+        }
+    }
+
+    gst_init(NULL, NULL);
+
+    // encode once and fan out to every instance, so that the generator's own cost does not grow with the instance count
+    auto       error    = (GError*)(nullptr);
+    const auto pipeline = AutoGstObject(gst_parse_launch(
+        "videotestsrc is-live=true ! video/x-raw,width=320,height=180,framerate=30/1 ! "
+        "x264enc tune=zerolatency speed-preset=ultrafast key-int-max=60 ! tee name=video_tee allow-not-linked=true "
+        "audiotestsrc is-live=true wave=ticks ! opusenc ! tee name=audio_tee allow-not-linked=true",
+        &error));
+    ensure(pipeline.get() != NULL, "failed to create source pipeline: {}", error != NULL ? error->message : "");
+
+    auto context = Context{
+        .pipeline  = pipeline.get(),
+        .audio_tee = gst_bin_get_by_name(GST_BIN(pipeline.get()), "audio_tee"),
+        .video_tee = gst_bin_get_by_name(GST_BIN(pipeline.get()), "video_tee"),
+    };
+    ensure(gst_element_set_state(pipeline.get(), GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+    // joins run on their own thread since each of them blocks until the instance is ready
+    auto joins_done = std::atomic_bool(false);
+    auto joiner     = std::thread([&]() {
+        for(auto p = 0; p < participants; p += 1) {
+            for(auto r = 0; r < rooms; r += 1) {
+                if(!join(context, host, r, p, insecure)) {
+                    std::println("room {} participant {} failed to join", r, p);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(join_interval_ms));
+            }
+        }
+        joins_done = true;
+    });
+
+    const auto instances  = size_t(rooms) * participants;
+    const auto interval   = std::chrono::seconds(5);
+    const auto start      = Clock::now();
+    auto       last_usage = get_usage();
+    auto       last_time  = start;
+    auto       deadline   = std::optional<Clock::time_point>();
+    while(!deadline || Clock::now() < *deadline) {
+        std::this_thread::sleep_for(interval);
+        const auto usage = get_usage();
+        const auto now   = Clock::now();
+        const auto cpu   = double(std::chrono::duration_cast<std::chrono::microseconds>(usage.cpu_time - last_usage.cpu_time).count()) /
+                         double(std::chrono::duration_cast<std::chrono::microseconds>(now - last_time).count()) * 100;
+        auto joined = size_t();
+        {
+            auto lock = std::lock_guard(context.lock);
+            joined    = std::ranges::count_if(context.instances, [](const Instance& i) { return i.join_latency.has_value(); });
+        }
+        // process-wide totals, averaged over the joined instances
+        std::println("t={}s joined={}/{} cpu={:.1f}% (avg {:.2f}%/instance) rss={}KiB (avg {}KiB/instance) threads={}",
+                     std::chrono::duration_cast<std::chrono::seconds>(now - start).count(), joined, instances,
+                     cpu, cpu / std::max<size_t>(joined, 1),
+                     usage.rss_kib, usage.rss_kib / std::max<size_t>(joined, 1),
+                     usage.threads);
+        last_usage = usage;
+        last_time  = now;
+        // failed joins are not waited for, the rest is still measured
+        if(!deadline && joins_done) {
+            deadline = now + std::chrono::seconds(duration_s);
+        }
+    }
+    joiner.join();
+    report(context);
+    std::println("max-rss={}KiB", get_usage().max_rss_kib);
+
+    gst_element_set_state(pipeline.get(), GST_STATE_NULL);
+    gst_object_unref(context.audio_tee);
+    gst_object_unref(context.video_tee);
+    return 0;
+}
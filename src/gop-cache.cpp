@@ -0,0 +1,79 @@
+#include <bit>
+
+#include "gop-cache.hpp"
+
+namespace {
+auto clear(GopCache& self) -> void {
+    for(const auto buffer : self.buffers) {
+        gst_buffer_unref(buffer);
+    }
+    self.buffers.clear();
+    self.bytes = 0;
+}
+
+auto append(GopCache& self, GstBuffer* const buffer) -> void {
+    const auto keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    if(keyframe) {
+        clear(self);
+        self.waiting_keyframe = false;
+    } else if(self.waiting_keyframe) {
+        return;
+    }
+    const auto size = gst_buffer_get_size(buffer);
+    if(self.bytes + size > self.max_bytes) {
+        // partial gop is useless
+        clear(self);
+        self.waiting_keyframe = true;
+        return;
+    }
+    self.buffers.push_back(gst_buffer_ref(buffer));
+    self.bytes += size;
+}
+
+auto replay(GopCache& self, GstPad* const pad) -> void {
+    auto buffers = std::vector<GstBuffer*>();
+    {
+        auto lock = std::lock_guard(self.lock);
+        for(const auto buffer : self.buffers) {
+            buffers.push_back(gst_buffer_ref(buffer));
+        }
+    }
+    self.replaying = true;
+    for(const auto buffer : buffers) {
+        // the new peer will report errors by itself
+        gst_pad_push(pad, buffer);
+    }
+    self.replaying = false;
+}
+
+auto pad_probe(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<GopCache*>(data);
+    if(self.replaying) {
+        return GST_PAD_PROBE_OK;
+    }
+    const auto buffer   = GST_PAD_PROBE_INFO_BUFFER(info);
+    const auto keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    if(self.replay_pending.exchange(false) && !keyframe) {
+        replay(self, pad);
+    }
+    auto lock = std::lock_guard(self.lock);
+    append(self, buffer);
+    return GST_PAD_PROBE_OK;
+}
+
+auto pad_linked_handler(GstPad* const /*pad*/, GstPad* const /*peer*/, gpointer const data) -> void {
+    // replayed from the streaming thread with the next buffer to keep the order
+    auto& self = *std::bit_cast<GopCache*>(data);
+    self.replay_pending.store(true);
+}
+} // namespace
+
+auto GopCache::install(GstPad* const pad) -> void {
+    g_object_set_data_full(G_OBJECT(pad), "jitsibin-gop-cache", this, [](gpointer data) { delete std::bit_cast<GopCache*>(data); });
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, pad_probe, this, NULL);
+    g_signal_connect(pad, "linked", G_CALLBACK(pad_linked_handler), this);
+}
+
+GopCache::~GopCache() {
+    clear(*this);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <gst/gst.h>
+
+// keeps the buffers since the last keyframe on a src pad and replays them when the pad is linked,
+// so that a decoder linked late can start without waiting for the next keyframe
+struct GopCache {
+    gsize max_bytes;
+
+    std::mutex              lock;
+    std::vector<GstBuffer*> buffers; // owned
+    gsize                   bytes            = 0;
+    bool                    waiting_keyframe = true; // cache overflowed or no keyframe seen yet
+
+    std::atomic_bool replay_pending = false;
+    bool             replaying      = false; // owned by the streaming thread
+
+    // the pad takes ownership of this cache
+    auto install(GstPad* pad) -> void;
+
+    ~GopCache();
+};
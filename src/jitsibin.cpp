@@ -7,10 +7,20 @@
 #include <coop/thread.hpp>
 #include <coop/timer.hpp>
 
+#include <gst/app/gstappsrc.h>
+#include <gst/audio/audio.h>
 #include <gst/rtp/gstrtpbasedepayload.h>
+#include <gst/rtp/gstrtpbuffer.h>
 #include <gst/rtp/gstrtpdefs.h>
 #include <gst/rtp/gstrtphdrext.h>
+#include <gst/video/video.h>
 
+#include <nice/agent.h>
+
+#include "abs-capture-time.hpp"
+#include "colibri-message.hpp"
+#include "decrypt-workers.hpp"
+#include "gop-cache.hpp"
 #include "gstutil/auto-gst-object.hpp"
 #include "jitsi/async-websocket.hpp"
 #include "jitsi/colibri.hpp"
@@ -24,8 +34,12 @@
 #include "jitsi/xmpp/elements.hpp"
 #include "jitsi/xmpp/negotiator.hpp"
 #include "jitsibin.hpp"
+#include "latency-tracer.hpp"
 #include "macros/autoptr.hpp"
+#include "pacer.hpp"
 #include "props.hpp"
+#include "stream-management.hpp"
+#include "task-pool.hpp"
 
 #define CUTIL_MACROS_PRINT_FUNC(...) LOG_ERROR(logger, __VA_ARGS__)
 #include "macros/coop-unwrap.hpp"
@@ -48,8 +62,87 @@ struct RealSelf {
 
     coop::AtomicEvent pipeline_ready;
     bool              connection_aborted = false;
-
-    Props props;
+    bool              sink_exposed       = false; // real sinks are linked to sink pads, runner thread only
+
+    conference::Conference*           conference           = nullptr; // valid while connected
+    conference::ConferenceCallbacks*  conference_callbacks = nullptr; // valid while connected
+    std::unique_ptr<colibri::Colibri> colibri;
+    std::set<std::string>             forwarded_participants; // last reported by the bridge
+    std::atomic_int                   sender_max_height   = -1;
+    std::atomic_int                   trickled_candidates = 0;
+    bool                              accept_sent         = false; // runner thread only
+    std::vector<jingle::Jingle>       pending_candidates;          // transport-info built before session-accept was sent
+
+    StreamManagement stream_management;
+
+    Props          props;
+    Pacer          pacer;
+    LatencyTracer  tracer;
+    DecryptWorkers decrypt_workers;
+    GstTaskPool*   jitterbuffer_pool = nullptr; // null if disabled
+
+    // abs-capture-time extension ids, -1 if not offered
+    int audio_hdrext_abs_capture_time = -1;
+    int video_hdrext_abs_capture_time = -1;
+
+    // red/48000/2 payload type, -1 if not offered or audio-red-distance is 0
+    int opus_red_pt = -1;
+
+    struct CaptureLatency {
+        std::string          participant_id;
+        std::atomic<guint64> latency     = 0; // smoothed, in nanoseconds
+        std::atomic<guint64> max_latency = 0;
+    };
+    std::mutex                         capture_latencies_lock;
+    std::map<uint32_t, CaptureLatency> capture_latencies; // ssrc to latency
+
+    // written by set_prop, read by the payloader probes
+    std::atomic_bool audio_muted         = false;
+    std::atomic_bool video_muted         = false;
+    std::atomic_bool video_wait_keyframe = false; // drop delta frames after unmute
+    std::atomic_bool video_drop_stale    = false; // the wait above was started by send-latency-budget
+    std::atomic_bool standby             = false; // read by the runner thread
+
+    // built by set_prop from receive-limit and participant selection, sent once colibri is connected
+    std::mutex  receiver_constraints_lock;
+    std::string receiver_constraints;
+
+    // video frames dropped for exceeding send-latency-budget
+    // delays are in nanoseconds and exclude the latency reported by upstream elements such as encoders
+    std::atomic<guint64>  send_delay             = 0; // of the latest video frame
+    std::atomic<guint64>  latency_budget_drops   = 0;
+    std::atomic<guint64>  upstream_video_latency = GST_CLOCK_TIME_NONE; // queried on demand
+    std::atomic<guint64>  sent_video_lateness    = 0;                   // of the latest video packet reaching nicesink
+    std::atomic<uint32_t> video_ssrc             = 0;
+
+    // received jitterbuffers, referenced, for per-ssrc stats
+    struct Jitterbuffer {
+        std::string participant_id;
+        GstElement* element;
+    };
+    std::mutex                       jitterbuffers_lock;
+    std::map<uint32_t, Jitterbuffer> jitterbuffers;
+
+    // mixed audio output, null if disabled
+    GstElement*                   audio_mixer = nullptr;
+    std::mutex                    participant_gains_lock;
+    std::map<std::string, double> participant_gains;
+
+    // sub-pipeline elements which are configured after session-initiate
+    struct SubPipeline {
+        GstElement*              nicesrc;
+        GstElement*              nicesink;
+        GstElement*              dtlssrtpenc;
+        GstElement*              dtlssrtpdec;
+        GstElement*              audio_pay;
+        GstElement*              video_pay;
+        GstElement*              rtpredenc = nullptr; // null if red is disabled
+        GstElement*              rtpreddec = nullptr;
+        std::vector<GstElement*> elements; // all of them, in locked state until finalized
+    };
+    SubPipeline          sub_pipeline;
+    std::atomic<guint64> preconstruct_time = 0; // nanoseconds
+    std::atomic<guint64> finalize_time     = 0;
 
     // for unblocking setup
     struct SinkElements {
@@ -69,6 +162,8 @@ auto logger = Logger("jitsibin");
 
 declare_autoptr(GstStructure, GstStructure, gst_structure_free);
 declare_autoptr(GString, gchar, g_free);
+declare_autoptr(GstCaps, GstCaps, gst_caps_unref);
+declare_autoptr(GstEvent, GstEvent, gst_event_unref);
 
 const auto codec_type_to_payloader_name = make_pair_table<CodecType, std::string_view>({
     {CodecType::Opus, "rtpopuspay"},
@@ -94,16 +189,296 @@ const auto codec_type_to_rtp_encoding_name = make_pair_table<CodecType, std::str
     {CodecType::Av1, "AV1"},
 });
 
+constexpr auto participant_id_data_key = "jitsibin-participant-id";
+
+auto split_participant_list(const std::string_view list) -> std::vector<std::string_view> {
+    auto ret = std::vector<std::string_view>();
+    for(const auto id : split(list, ",")) {
+        if(!id.empty()) {
+            ret.push_back(id);
+        }
+    }
+    return ret;
+}
+
+auto build_receiver_video_constraints(const Props& props) -> std::string {
+    const auto selected = split_participant_list(props.selected_participants);
+    const auto on_stage = split_participant_list(props.on_stage_participants);
+    return colibri_message::build({
+        .last_n   = props.last_n,
+        .selected = selected,
+        .on_stage = on_stage,
+    });
+}
+
+auto send_colibri_message(RealSelf& self, std::string message) -> void {
+    if(!self.runner_thread.joinable()) {
+        // not connected yet, props are applied after connection
+        return;
+    }
+    self.injector.inject_task([](RealSelf& self, const std::string message) -> coop::Async<void> {
+        if(self.colibri) {
+            LOG_DEBUG(logger, "sending colibri message {}", message);
+            self.colibri->ws_context.send(message);
+        }
+        co_return;
+    }(self, std::move(message)));
+}
+
+auto update_mute_state(RealSelf& self, const bool is_audio, const bool muted) -> void {
+    auto& state = is_audio ? self.audio_muted : self.video_muted;
+    if(state.exchange(muted) == muted) {
+        return;
+    }
+    LOG_INFO(logger, "{} {}", is_audio ? "audio" : "video", muted ? "muted" : "unmuted");
+
+    // let upstream encoders pause
+    const auto pad = is_audio ? self.audio_sink_elements.sink_pad : self.video_sink_elements.sink_pad;
+    gst_pad_push_event(pad, gst_event_new_custom(GST_EVENT_CUSTOM_UPSTREAM,
+                                                 gst_structure_new("jitsi-mute",
+                                                                   "muted", G_TYPE_BOOLEAN, muted ? TRUE : FALSE,
+                                                                   NULL)));
+    if(!is_audio && !muted) {
+        self.video_wait_keyframe.store(true);
+        gst_pad_push_event(pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+    }
+
+    if(!self.runner_thread.joinable()) {
+        return;
+    }
+    self.injector.inject_task([](RealSelf& self, const bool is_audio, const bool muted) -> coop::Async<void> {
+        if(self.conference == nullptr) {
+            co_return;
+        }
+        (is_audio ? self.conference->config.audio_muted : self.conference->config.video_muted) = muted;
+        self.conference->send_presence();
+        co_return;
+    }(self, is_audio, muted));
+}
+
+auto leave_standby(RealSelf& self) -> void;
+
 auto set_prop(GObject* obj, const guint id, const GValue* const value, GParamSpec* const spec) -> void {
     const auto jitsibin = GST_JITSIBIN(obj);
     auto&      self     = *jitsibin->real_self;
     self.props.handle_set_prop(id, value, spec);
+    switch(id) {
+    case Props::video_pacing_rate_id:
+        self.pacer.bitrate.store(guint64(self.props.video_pacing_rate) * 1000);
+        break;
+    case Props::audio_muted_id:
+        update_mute_state(self, true, self.props.audio_muted);
+        break;
+    case Props::video_muted_id:
+        update_mute_state(self, false, self.props.video_muted);
+        break;
+    case Props::last_n_id:
+    case Props::selected_participants_id:
+    case Props::on_stage_participants_id: {
+        // props are not read from other threads, they get this copy instead
+        auto message = build_receiver_video_constraints(self.props);
+        {
+            auto lock                 = std::lock_guard(self.receiver_constraints_lock);
+            self.receiver_constraints = message;
+        }
+        send_colibri_message(self, std::move(message));
+        break;
+    }
+    case Props::standby_id:
+        self.standby.store(self.props.standby);
+        if(self.props.standby || !self.runner_thread.joinable()) {
+            break;
+        }
+        // serialize with pipeline construction
+        self.injector.inject_task([](RealSelf& self) -> coop::Async<void> {
+            leave_standby(self);
+            co_return;
+        }(self));
+        break;
+    default:
+        break;
+    }
+}
+
+auto append_structure_to_array(GValue* const array, GstStructure* const structure) -> void {
+    auto value = GValue(G_VALUE_INIT);
+    g_value_init(&value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed(&value, structure);
+    gst_value_array_append_and_take_value(array, &value);
+}
+
+auto collect_stats(RealSelf& self) -> GstStructure* {
+    const auto stats = gst_structure_new_empty("application/x-jitsibin-stats");
+    gst_structure_set(stats,
+                      "pacer-queue-delay", G_TYPE_UINT64, self.pacer.queue_delay.load(),
+                      "pacer-max-queue-delay", G_TYPE_UINT64, self.pacer.max_queue_delay.load(),
+                      "preconstruct-time", G_TYPE_UINT64, self.preconstruct_time.load(),
+                      "finalize-time", G_TYPE_UINT64, self.finalize_time.load(),
+                      "send-delay", G_TYPE_UINT64, self.send_delay.load(),
+                      "latency-budget-drops", G_TYPE_UINT64, self.latency_budget_drops.load(),
+                      NULL);
+
+    auto capture_latencies = GValue(G_VALUE_INIT);
+    gst_value_array_init(&capture_latencies, 0);
+    {
+        auto lock = std::lock_guard(self.capture_latencies_lock);
+        for(const auto& [ssrc, latency] : self.capture_latencies) {
+            append_structure_to_array(&capture_latencies,
+                                      gst_structure_new("capture-latency",
+                                                        "participant", G_TYPE_STRING, latency.participant_id.data(),
+                                                        "ssrc", G_TYPE_UINT, ssrc,
+                                                        "latency", G_TYPE_UINT64, latency.latency.load(),
+                                                        "max-latency", G_TYPE_UINT64, latency.max_latency.load(),
+                                                        NULL));
+        }
+    }
+    gst_structure_take_value(stats, "capture-latency", &capture_latencies);
+
+    // loss after retransmission and rtx overhead for each received stream
+    auto jitterbuffers = GValue(G_VALUE_INIT);
+    gst_value_array_init(&jitterbuffers, 0);
+    {
+        auto lock = std::lock_guard(self.jitterbuffers_lock);
+        for(const auto& [ssrc, jitterbuffer] : self.jitterbuffers) {
+            auto jitterbuffer_stats = (GstStructure*)(nullptr);
+            g_object_get(jitterbuffer.element, "stats", &jitterbuffer_stats, NULL);
+            if(jitterbuffer_stats == NULL) {
+                continue;
+            }
+            gst_structure_set_name(jitterbuffer_stats, "jitterbuffer");
+            gst_structure_set(jitterbuffer_stats,
+                              "participant", G_TYPE_STRING, jitterbuffer.participant_id.data(),
+                              "ssrc", G_TYPE_UINT, ssrc,
+                              NULL);
+            append_structure_to_array(&jitterbuffers, jitterbuffer_stats);
+        }
+    }
+    gst_structure_take_value(stats, "jitterbuffers", &jitterbuffers);
+
+    if(self.props.latency_tracing) {
+        self.tracer.fill_stats(stats);
+    }
+    if(self.props.decrypt_workers > 0) {
+        self.decrypt_workers.fill_stats(stats);
+    }
+
+    return stats;
 }
 
 auto get_prop(GObject* obj, const guint id, GValue* const value, GParamSpec* const spec) -> void {
     const auto jitsibin = GST_JITSIBIN(obj);
     auto&      self     = *jitsibin->real_self;
-    self.props.handle_get_prop(id, value, spec);
+    switch(id) {
+    case Props::stats_id:
+        g_value_take_boxed(value, collect_stats(self));
+        break;
+    case Props::sender_max_height_id:
+        g_value_set_int(value, self.sender_max_height.load());
+        break;
+    default:
+        self.props.handle_get_prop(id, value, spec);
+        break;
+    }
+}
+
+auto find_hdrext_id(const jingle::Jingle& jingle, const std::string_view media, const std::string_view uri) -> int {
+    for(const auto& content : jingle.contents) {
+        for(const auto& description : content.descriptions) {
+            if(description.media != media) {
+                continue;
+            }
+            for(const auto& ext : description.rtp_header_exts) {
+                if(ext.uri == uri) {
+                    return ext.id;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+auto iequals(const std::string_view a, const std::string_view b) -> bool {
+    return std::ranges::equal(a, b, [](const char l, const char r) { return std::tolower(l) == std::tolower(r); });
+}
+
+// first description of the media, null if not found
+auto find_description(auto& jingle, const std::string_view media) -> decltype(&jingle.contents[0].descriptions[0]) {
+    for(auto& content : jingle.contents) {
+        for(auto& description : content.descriptions) {
+            if(description.media == media) {
+                return &description;
+            }
+        }
+    }
+    return nullptr;
+}
+
+auto find_payload_type(auto& description, const std::string_view name) -> decltype(&description.payload_types[0]) {
+    for(auto& payload_type : description.payload_types) {
+        if(iequals(payload_type.name, name)) {
+            return &payload_type;
+        }
+    }
+    return nullptr;
+}
+
+auto set_fmtp_parameter(auto& payload_type, const std::string_view name, const std::string_view value) -> void {
+    for(auto& parameter : payload_type.parameters) {
+        if(parameter.name == name) {
+            parameter.value = value;
+            return;
+        }
+    }
+    payload_type.parameters.push_back({.name = std::string(name), .value = std::string(value)});
+}
+
+auto find_opus_red_pt(const RealSelf& self, const jingle::Jingle& initiate) -> int {
+    if(self.props.audio_red_distance == 0) {
+        return -1;
+    }
+    const auto audio = find_description(initiate, "audio");
+    if(audio == nullptr) {
+        return -1;
+    }
+    const auto red = find_payload_type(*audio, "red");
+    return red != nullptr ? red->id : -1;
+}
+
+// jingle handler accepts the primary codecs only, add what the optional audio features need
+auto complete_accept_jingle(const RealSelf& self, const jingle::Jingle& initiate, jingle::Jingle& accept) -> void {
+    const auto offered = find_description(initiate, "audio");
+    const auto audio   = find_description(accept, "audio");
+    if(offered == nullptr || audio == nullptr) {
+        return;
+    }
+    // fmtp of the receiver, tells the peers that we can decode them
+    if(const auto opus = find_payload_type(*audio, "opus"); opus != nullptr) {
+        if(self.props.audio_fec) {
+            set_fmtp_parameter(*opus, "useinbandfec", "1");
+        }
+        if(self.props.audio_dtx) {
+            set_fmtp_parameter(*opus, "usedtx", "1");
+        }
+    }
+    // echo the offered red with its fmtp
+    if(self.opus_red_pt != -1 && find_payload_type(*audio, "red") == nullptr) {
+        audio->payload_types.push_back(*find_payload_type(*offered, "red"));
+    }
+}
+
+// accept the abs-capture-time extension for the media it is offered on, peers do not send or keep it otherwise
+auto accept_abs_capture_time(const jingle::Jingle& initiate, jingle::Jingle& accept, const std::string_view media) -> void {
+    const auto offered  = find_description(initiate, media);
+    const auto accepted = find_description(accept, media);
+    if(offered == nullptr || accepted == nullptr) {
+        return;
+    }
+    const auto is_abs_capture_time = [](const auto& ext) { return ext.uri == rtp_hdrext_abs_capture_time_uri; };
+    const auto ext                 = std::ranges::find_if(offered->rtp_header_exts, is_abs_capture_time);
+    if(ext == offered->rtp_header_exts.end() || std::ranges::any_of(accepted->rtp_header_exts, is_abs_capture_time)) {
+        return;
+    }
+    accepted->rtp_header_exts.push_back(*ext);
 }
 
 auto rtpbin_request_pt_map_handler(GstElement* const /*rtpbin*/, const guint session, const guint pt, const gpointer data) -> GstCaps* {
@@ -136,6 +511,12 @@ auto rtpbin_request_pt_map_handler(GstElement* const /*rtpbin*/, const guint ses
                                         name.data(), G_TYPE_STRING, rtp_hdrext_ssrc_audio_level_uri,
                                         NULL);
                 }
+                if(const auto ext = self.audio_hdrext_abs_capture_time; ext != -1) {
+                    const auto name = std::format("extmap-{}", ext);
+                    gst_caps_set_simple(caps,
+                                        name.data(), G_TYPE_STRING, rtp_hdrext_abs_capture_time_uri,
+                                        NULL);
+                }
                 return caps;
             } break;
             case CodecType::H264:
@@ -154,6 +535,12 @@ auto rtpbin_request_pt_map_handler(GstElement* const /*rtpbin*/, const guint ses
                                         name.data(), G_TYPE_STRING, rtp_hdrext_transport_cc_uri,
                                         NULL);
                 }
+                if(const auto ext = self.video_hdrext_abs_capture_time; ext != -1) {
+                    const auto name = std::format("extmap-{}", ext);
+                    gst_caps_set_simple(caps,
+                                        name.data(), G_TYPE_STRING, rtp_hdrext_abs_capture_time_uri,
+                                        NULL);
+                }
                 return caps;
             } break;
             }
@@ -167,6 +554,14 @@ auto rtpbin_request_pt_map_handler(GstElement* const /*rtpbin*/, const guint ses
             return caps;
         }
     }
+    if(self.opus_red_pt != -1 && int(pt) == self.opus_red_pt) {
+        gst_caps_set_simple(caps,
+                            "media", G_TYPE_STRING, "audio",
+                            "encoding-name", G_TYPE_STRING, "RED",
+                            "clock-rate", G_TYPE_INT, 48000,
+                            NULL);
+        return caps;
+    }
     g_object_unref(caps);
     LOG_WARN(logger, "unknown payload type requested");
     return NULL;
@@ -189,6 +584,20 @@ auto rtpbin_new_jitterbuffer_handler(GstElement* const /*rtpbin*/, GstElement* c
         return;
     }
     LOG_DEBUG(logger, "jitterbuffer is for remote source {}", source->participant_id);
+    {
+        auto  lock  = std::lock_guard(self.jitterbuffers_lock);
+        auto& entry = self.jitterbuffers[ssrc];
+        if(entry.element != nullptr) {
+            gst_object_unref(entry.element);
+        }
+        entry = {source->participant_id, GST_ELEMENT(gst_object_ref(jitterbuffer))};
+    }
+    if(self.props.output_format == OutputFormat::Rtp) {
+        // packets are handed to the application, which may do its own buffering
+        g_object_set(jitterbuffer,
+                     "latency", self.props.jitterbuffer_latency,
+                     NULL);
+    }
     if(source->type != SourceType::Video) {
         return;
     }
@@ -239,6 +648,8 @@ auto rtpbin_request_aux_sender_handler(GstElement* const /*rtpbin*/, const guint
     g_object_set(rtprtxsend.get(),
                  "payload-type-map", pt_map.get(),
                  "ssrc-map", ssrc_map.get(),
+                 "max-size-packets", self.props.rtx_history_packets,
+                 "max-size-time", self.props.rtx_history_time,
                  NULL);
     gst_bin_add(GST_BIN(bin.get()), rtprtxsend.get());
 
@@ -276,15 +687,242 @@ auto rtpbin_request_aux_receiver_handler(GstElement* const /*rtpbin*/, const gui
     return bin.release();
 }
 
+auto rtpbin_request_fec_decoder_handler(GstElement* const /*rtpbin*/, const guint session, gpointer const data) -> GstElement* {
+    auto& self = *std::bit_cast<RealSelf*>(data);
+    LOG_DEBUG(logger, "rtpbin request-fec-decoder session={}", session);
+    if(self.props.audio_red_distance == 0) {
+        return NULL;
+    }
+
+    // requested while the sub-pipeline is preconstructed, the payload type is set by finalize_sub_pipeline
+    // packets with other payload types are passed through as is
+    const auto rtpreddec = gst_element_factory_make("rtpreddec", NULL);
+    ensure(rtpreddec != NULL, "failed to create rtpreddec");
+    g_object_set(rtpreddec,
+                 "pt", -1,
+                 NULL);
+    self.sub_pipeline.rtpreddec = rtpreddec;
+    return rtpreddec;
+}
+
 auto pay_depay_request_extension_handler(GstRTPBaseDepayload* const /*depay*/, const guint ext_id, const gchar* ext_uri, gpointer const /*data*/) -> GstRTPHeaderExtension* {
     LOG_DEBUG(logger, "(de)payloader extension request ext_id={} ext_uri={}", ext_id, ext_uri);
 
-    auto ext = gst_rtp_header_extension_create_from_uri(ext_uri);
+    // not provided by gstreamer
+    auto ext = std::string_view(ext_uri) == rtp_hdrext_abs_capture_time_uri ? abs_capture_time_extension_new() : gst_rtp_header_extension_create_from_uri(ext_uri);
     ensure(ext != NULL);
     gst_rtp_header_extension_set_id(ext, ext_id);
     return ext;
 }
 
+// the latency is attached to the buffer, so that it reaches the application through the ghost pad
+auto depay_src_capture_latency_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      latency = *std::bit_cast<RealSelf::CaptureLatency*>(data);
+    const auto meta    = gst_buffer_get_reference_timestamp_meta(GST_PAD_PROBE_INFO_BUFFER(info), abs_capture_time_meta_caps());
+    if(meta == NULL) {
+        return GST_PAD_PROBE_OK;
+    }
+    const auto now = abs_capture_time_now();
+    if(now < meta->timestamp) {
+        // clocks of the sender and ours are not synchronized
+        return GST_PAD_PROBE_OK;
+    }
+    const auto sample = now - meta->timestamp;
+    const auto buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+    gst_buffer_add_reference_timestamp_meta(buffer, abs_capture_latency_meta_caps(), sample, GST_CLOCK_TIME_NONE);
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+    const auto prev   = latency.latency.load();
+    latency.latency.store(prev == 0 ? sample : (prev * 15 + sample) / 16);
+    if(sample > latency.max_latency.load()) {
+        latency.max_latency.store(sample);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+// audio level extension marks silent packets, skip decoding them
+// data is the silent-audio-level at link time, in -dBov
+auto silent_audio_probe(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    const auto buffer    = GST_PAD_PROBE_INFO_BUFFER(info);
+    const auto meta      = gst_buffer_get_audio_level_meta(buffer);
+    const auto threshold = GPOINTER_TO_UINT(data);
+    if(meta == NULL || meta->level < threshold) {
+        return GST_PAD_PROBE_OK;
+    }
+    // tell the mixer that this pad has nothing rather than letting it time out
+    if(GST_BUFFER_PTS_IS_VALID(buffer)) {
+        gst_pad_push_event(pad, gst_event_new_gap(GST_BUFFER_PTS(buffer), GST_BUFFER_DURATION(buffer)));
+    }
+    return GST_PAD_PROBE_DROP;
+}
+
+// depay -> opusdec -> audioconvert -> audiomixer
+auto link_to_audio_mixer(RealSelf& self, const std::string& participant_id, GstPad* const depay_src_pad) -> bool {
+    const auto decoder = AutoGstObject(gst_element_factory_make("opusdec", NULL));
+    ensure(decoder.get() != NULL, "failed to create opusdec");
+    g_object_set(decoder.get(),
+                 "use-inband-fec", self.props.audio_fec ? TRUE : FALSE,
+                 NULL);
+    ensure(call_vfunc(self, add_element, decoder.get()) == TRUE);
+    const auto convert = AutoGstObject(gst_element_factory_make("audioconvert", NULL));
+    ensure(convert.get() != NULL, "failed to create audioconvert");
+    ensure(call_vfunc(self, add_element, convert.get()) == TRUE);
+    ensure(gst_element_link(decoder.get(), convert.get()) == TRUE);
+
+    const auto mixer_pad = AutoGstObject(gst_element_request_pad_simple(self.audio_mixer, "sink_%u"));
+    ensure(mixer_pad.get() != NULL);
+    g_object_set_data_full(G_OBJECT(mixer_pad.get()), participant_id_data_key, g_strdup(participant_id.data()), g_free);
+    {
+        auto lock = std::lock_guard(self.participant_gains_lock);
+        if(const auto i = self.participant_gains.find(participant_id); i != self.participant_gains.end()) {
+            g_object_set(mixer_pad.get(), "volume", i->second, NULL);
+        }
+    }
+    const auto convert_src_pad = AutoGstObject(gst_element_get_static_pad(convert.get(), "src"));
+    ensure(convert_src_pad.get() != NULL);
+    ensure(gst_pad_link(convert_src_pad.get(), mixer_pad.get()) == GST_PAD_LINK_OK);
+    const auto decoder_sink_pad = AutoGstObject(gst_element_get_static_pad(decoder.get(), "sink"));
+    ensure(decoder_sink_pad.get() != NULL);
+    ensure(gst_pad_link(depay_src_pad, decoder_sink_pad.get()) == GST_PAD_LINK_OK);
+
+    ensure(gst_element_sync_state_with_parent(convert.get()));
+    ensure(gst_element_sync_state_with_parent(decoder.get()));
+    gst_pad_add_probe(depay_src_pad, GST_PAD_PROBE_TYPE_BUFFER, silent_audio_probe, GUINT_TO_POINTER(self.props.silent_audio_level), NULL);
+    return true;
+}
+
+// link a new depayloader to the rtpbin pad, the returned element is owned by the bin
+auto create_depayloader(RealSelf& self, GstPad* const pad, const uint32_t ssrc, const std::string_view depayloader_name) -> GstElement* {
+    const auto depay = AutoGstObject(gst_element_factory_make(depayloader_name.data(), NULL));
+    ensure(depay.get() != NULL, "failed to create {}", depayloader_name);
+    g_object_set(depay.get(),
+                 "auto-header-extension", FALSE,
+                 NULL);
+    g_signal_connect(depay.get(), "request-extension", G_CALLBACK(pay_depay_request_extension_handler), &self);
+    ensure(call_vfunc(self, add_element, depay.get()) == TRUE);
+    ensure(gst_element_sync_state_with_parent(depay.get()));
+    const auto depay_sink_pad = AutoGstObject(gst_element_get_static_pad(depay.get(), "sink"));
+    ensure(depay_sink_pad.get() != NULL);
+    ensure(gst_pad_link(pad, GST_PAD(depay_sink_pad.get())) == GST_PAD_LINK_OK);
+    const auto depay_src_pad = AutoGstObject(gst_element_get_static_pad(depay.get(), "src"));
+    ensure(depay_src_pad.get() != NULL);
+
+    if(self.props.latency_tracing) {
+        self.tracer.trace_sync_stage(LatencyTracer::Stage::Depayload, depay_sink_pad.get(), depay_src_pad.get());
+    }
+
+    // measure capture-to-output latency
+    if(self.audio_hdrext_abs_capture_time != -1 || self.video_hdrext_abs_capture_time != -1) {
+        auto  lock    = std::lock_guard(self.capture_latencies_lock);
+        auto& latency = self.capture_latencies[ssrc];
+        gst_pad_add_probe(depay_src_pad.get(), GST_PAD_PROBE_TYPE_BUFFER, depay_src_capture_latency_probe, &latency, NULL);
+    }
+    return depay.get();
+}
+
+auto get_src_template_caps(const std::string_view factory_name) -> GstCaps* {
+    const auto factory = AutoGstObject(gst_element_factory_find(factory_name.data()));
+    ensure(factory.get() != NULL, "no such element {}", factory_name);
+    for(auto i = gst_element_factory_get_static_pad_templates(factory.get()); i != NULL; i = i->next) {
+        const auto templ = std::bit_cast<GstStaticPadTemplate*>(i->data);
+        if(templ->direction == GST_PAD_SRC) {
+            return gst_static_pad_template_get_caps(templ);
+        }
+    }
+    bail("{} has no src pad template", factory_name);
+}
+
+// received stream whose depayloader exists only while the exposed pad is linked
+// owned by the ghost pad
+struct LazyBranch {
+    RealSelf*       owner;
+    GstPad*         rtpbin_pad; // referenced
+    uint32_t        ssrc;
+    std::string     depayloader_name;
+    bool            is_video;
+    GstElement*     depay      = nullptr; // streaming thread only
+    gulong          drop_probe = 0;
+    std::atomic_int pending    = 0; // link state changes not applied yet
+
+    auto build(GstPad* ghost_pad) -> bool;
+    auto teardown(GstPad* ghost_pad) -> bool;
+    auto install(GstPad* ghost_pad) -> void;
+
+    ~LazyBranch();
+};
+
+// packets of unlinked pads are dropped, except those that wake up a pending block probe
+auto lazy_branch_drop_probe(GstPad* const /*pad*/, GstPadProbeInfo* const /*info*/, gpointer const data) -> GstPadProbeReturn {
+    const auto& branch = *std::bit_cast<LazyBranch*>(data);
+    return branch.pending.load() > 0 ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
+}
+
+auto LazyBranch::build(GstPad* const ghost_pad) -> bool {
+    LOG_DEBUG(logger, "creating receive branch for ssrc {}", ssrc);
+    depay = create_depayloader(*owner, rtpbin_pad, ssrc, depayloader_name);
+    ensure(depay != nullptr);
+    const auto depay_src_pad = AutoGstObject(gst_element_get_static_pad(depay, "src"));
+    ensure(depay_src_pad.get() != NULL);
+    ensure(gst_ghost_pad_set_target(GST_GHOST_PAD(ghost_pad), depay_src_pad.get()) == TRUE);
+    gst_pad_remove_probe(rtpbin_pad, std::exchange(drop_probe, 0));
+    if(is_video) {
+        // packets before this point are gone, let the sender refresh the decoder state
+        gst_pad_send_event(rtpbin_pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+    }
+    return true;
+}
+
+auto LazyBranch::teardown(GstPad* const ghost_pad) -> bool {
+    LOG_DEBUG(logger, "removing receive branch for ssrc {}", ssrc);
+    auto& self = *owner;
+    drop_probe = gst_pad_add_probe(rtpbin_pad, GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), lazy_branch_drop_probe, this, NULL);
+    ensure(gst_ghost_pad_set_target(GST_GHOST_PAD(ghost_pad), NULL) == TRUE);
+    const auto depay_sink_pad = AutoGstObject(gst_element_get_static_pad(depay, "sink"));
+    ensure(depay_sink_pad.get() != NULL);
+    gst_pad_unlink(rtpbin_pad, depay_sink_pad.get());
+    gst_element_set_state(depay, GST_STATE_NULL);
+    ensure(call_vfunc(self, remove_element, std::exchange(depay, nullptr)) == TRUE);
+    return true;
+}
+
+// the rtpbin pad is blocked here, so the branch can be changed while nothing streams into it
+// follows the current link state of the ghost pad, since it may have changed again before the block
+auto lazy_branch_block_callback(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    const auto ghost_pad = std::bit_cast<GstPad*>(data);
+    auto&      branch    = *std::bit_cast<LazyBranch*>(g_object_get_data(G_OBJECT(ghost_pad), "jitsibin-lazy-branch"));
+    const auto linked    = gst_pad_is_linked(ghost_pad) == TRUE;
+    if(linked && branch.depay == nullptr) {
+        branch.build(ghost_pad);
+    } else if(!linked && branch.depay != nullptr) {
+        branch.teardown(ghost_pad);
+    }
+    branch.pending.fetch_sub(1);
+    if(linked || !(info->type & (GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST))) {
+        return GST_PAD_PROBE_REMOVE;
+    }
+    // the drop probe added by teardown does not apply to the data already being pushed
+    gst_pad_remove_probe(pad, GST_PAD_PROBE_INFO_ID(info));
+    return GST_PAD_PROBE_DROP;
+}
+
+// called on the thread that (un)linked the ghost pad, defer the work to the streaming thread
+auto lazy_branch_link_changed_handler(GstPad* const ghost_pad, GstPad* const /*peer*/, gpointer const data) -> void {
+    auto& branch = *std::bit_cast<LazyBranch*>(data);
+    branch.pending.fetch_add(1);
+    gst_pad_add_probe(branch.rtpbin_pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, lazy_branch_block_callback,
+                      gst_object_ref(ghost_pad), gst_object_unref);
+}
+
+auto LazyBranch::install(GstPad* const ghost_pad) -> void {
+    drop_probe = gst_pad_add_probe(rtpbin_pad, GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), lazy_branch_drop_probe, this, NULL);
+    g_object_set_data_full(G_OBJECT(ghost_pad), "jitsibin-lazy-branch", this, [](gpointer data) { delete std::bit_cast<LazyBranch*>(data); });
+    g_signal_connect(ghost_pad, "linked", G_CALLBACK(lazy_branch_link_changed_handler), this);
+    g_signal_connect(ghost_pad, "unlinked", G_CALLBACK(lazy_branch_link_changed_handler), this);
+}
+
+LazyBranch::~LazyBranch() {
+    gst_object_unref(rtpbin_pad);
+}
+
 auto rtpbin_pad_added_handler(GstElement* const /*rtpbin*/, GstPad* const pad, gpointer const data) -> void {
     auto& self = *std::bit_cast<RealSelf*>(data);
     LOG_DEBUG(logger, "rtpbin pad_added");
@@ -308,19 +946,11 @@ auto rtpbin_pad_added_handler(GstElement* const /*rtpbin*/, GstPad* const pad, g
         source = &i->second;
     }
 
-    auto use_fakesink = false;
+    // receive-limit is live, so a stream arriving while it is 0 is exposed too and resumes when the limit is raised
     if(source == nullptr) {
         // jicofo did not send source-add jingle?
         // we cannot handle this pad since we do not know its format.
         LOG_WARN(logger, "unknown ssrc {}\ninstalling fakesink...", ssrc);
-        use_fakesink = true;
-    } else if(self.props.last_n == 0) {
-        // why jvb send stream while last_n == 0?
-        // user probably do not handle this pad.
-        LOG_WARN(logger, "unwanted stream found. installing fakesink...");
-        use_fakesink = true;
-    }
-    if(use_fakesink) {
         // add fakesink to prevent broken pipeline
         const auto fakesink = AutoGstObject(gst_element_factory_make("fakesink", NULL));
         ensure(call_vfunc(self, add_element, fakesink.get()) == TRUE);
@@ -333,39 +963,263 @@ auto rtpbin_pad_added_handler(GstElement* const /*rtpbin*/, GstPad* const pad, g
 
     LOG_DEBUG(logger, "pad added for remote source {}", source->participant_id);
 
-    // add depayloader
     unwrap(codec, jingle_session.find_codec_by_tx_pt(pt), "cannot find depayloader for such payload type");
-    unwrap(depayloader_name, codec_type_to_depayloader_name.find(codec.type));
-    const auto depay = AutoGstObject(gst_element_factory_make(depayloader_name.data(), NULL));
-    g_object_set(depay.get(),
-                 "auto-header-extension", FALSE,
-                 NULL);
-    g_signal_connect(depay.get(), "request-extension", G_CALLBACK(pay_depay_request_extension_handler), &self);
-    ensure(call_vfunc(self, add_element, depay.get()) == TRUE);
-    ensure(gst_element_sync_state_with_parent(depay.get()));
-    const auto depay_sink_pad = AutoGstObject(gst_element_get_static_pad(depay.get(), "sink"));
-    ensure(depay_sink_pad.get() != NULL);
-    ensure(gst_pad_link(pad, GST_PAD(depay_sink_pad.get())) == GST_PAD_LINK_OK);
-
-    // expose src pad
     unwrap(encoding_name, codec_type_to_rtp_encoding_name.find(codec.type));
     const auto ghost_pad_name = std::format("{}_{}_{}", source->participant_id, encoding_name.data(), ssrc);
 
-    const auto depay_src_pad = AutoGstObject(gst_element_get_static_pad(depay.get(), "src"));
-    ensure(depay_src_pad.get() != NULL);
+    if(self.props.output_format == OutputFormat::Rtp) {
+        // expose rtpbin pad as is, caps are filled by request-pt-map
+        if(self.props.latency_tracing) {
+            self.tracer.trace_async_stage_output(LatencyTracer::Stage::Jitterbuffer, pad);
+            self.tracer.count_packets(source->participant_id, pad);
+        }
+        const auto ghost_pad = AutoGstObject(gst_ghost_pad_new(ghost_pad_name.data(), pad));
+        ensure(ghost_pad.get() != NULL);
+        ensure(gst_element_add_pad(GST_ELEMENT(self.bin), ghost_pad.get()) == TRUE);
+        return;
+    }
+
+    unwrap(depayloader_name, codec_type_to_depayloader_name.find(codec.type));
+    if(self.props.latency_tracing) {
+        self.tracer.trace_async_stage_output(LatencyTracer::Stage::Jitterbuffer, pad);
+        self.tracer.count_packets(source->participant_id, pad);
+    }
+    if(self.audio_hdrext_abs_capture_time != -1 || self.video_hdrext_abs_capture_time != -1) {
+        auto  lock             = std::lock_guard(self.capture_latencies_lock);
+        auto& latency          = self.capture_latencies[ssrc];
+        latency.participant_id = source->participant_id;
+    }
+
+    if(self.audio_mixer != nullptr && source->type == SourceType::Audio) {
+        const auto depay = create_depayloader(self, pad, ssrc, depayloader_name);
+        ensure(depay != nullptr);
+        const auto depay_src_pad = AutoGstObject(gst_element_get_static_pad(depay, "src"));
+        ensure(depay_src_pad.get() != NULL);
+        ensure(link_to_audio_mixer(self, source->participant_id, depay_src_pad.get()));
+        return;
+    }
+
+    if(self.props.lazy_receive) {
+        // announce the stream with the caps depayloader will produce, but build it when the pad is linked
+        const auto caps = AutoGstCaps(get_src_template_caps(depayloader_name));
+        ensure(caps.get() != NULL);
+        const auto templ = AutoGstObject(gst_pad_template_new("src_%s", GST_PAD_SRC, GST_PAD_SOMETIMES, caps.get()));
+        ensure(templ.get() != NULL);
+        const auto ghost_pad = AutoGstObject(gst_ghost_pad_new_no_target_from_template(ghost_pad_name.data(), templ.get()));
+        ensure(ghost_pad.get() != NULL);
+        (new LazyBranch{
+             .owner            = &self,
+             .rtpbin_pad       = GST_PAD(gst_object_ref(pad)),
+             .ssrc             = ssrc,
+             .depayloader_name = std::string(depayloader_name),
+             .is_video         = source->type == SourceType::Video,
+         })
+            ->install(ghost_pad.get());
+        ensure(gst_element_add_pad(GST_ELEMENT(self.bin), ghost_pad.get()) == TRUE);
+        return;
+    }
 
+    const auto depay = create_depayloader(self, pad, ssrc, depayloader_name);
+    ensure(depay != nullptr);
+    const auto depay_src_pad = AutoGstObject(gst_element_get_static_pad(depay, "src"));
+    ensure(depay_src_pad.get() != NULL);
     const auto ghost_pad = AutoGstObject(gst_ghost_pad_new(ghost_pad_name.data(), depay_src_pad.get()));
     ensure(ghost_pad.get() != NULL);
 
+    if(self.props.keyframe_cache_size > 0 && source->type == SourceType::Video) {
+        (new GopCache{.max_bytes = self.props.keyframe_cache_size})->install(ghost_pad.get());
+    }
+
     ensure(gst_element_add_pad(GST_ELEMENT(self.bin), ghost_pad.get()) == TRUE);
 
     return;
 }
 
-auto construct_sub_pipeline(RealSelf& self) -> bool {
-    static auto serial_num     = std::atomic_int(0);
-    const auto& jingle_session = self.jingle_handler->get_session();
+auto trace_sync_element(LatencyTracer& tracer, const LatencyTracer::Stage stage, GstElement* const element, const char* const input, const char* const output) -> bool {
+    const auto input_pad = AutoGstObject(gst_element_get_static_pad(element, input));
+    ensure(input_pad.get() != NULL);
+    const auto output_pad = AutoGstObject(gst_element_get_static_pad(element, output));
+    ensure(output_pad.get() != NULL);
+    tracer.trace_sync_stage(stage, input_pad.get(), output_pad.get());
+    return true;
+}
+
+auto trace_async_pads(LatencyTracer& tracer, const LatencyTracer::Stage stage, GstElement* const input_element, const char* const input, GstElement* const output_element, const char* const output) -> bool {
+    const auto input_pad = AutoGstObject(gst_element_get_static_pad(input_element, input));
+    ensure(input_pad.get() != NULL);
+    const auto output_pad = AutoGstObject(gst_element_get_static_pad(output_element, output));
+    ensure(output_pad.get() != NULL);
+    tracer.trace_async_stage_input(stage, input_pad.get());
+    tracer.trace_async_stage_output(stage, output_pad.get());
+    return true;
+}
+
+// limit height of upstream video to what the bridge wants
+// -1 is unlimited, and with 0 video is dropped by the mute probe so the caps are left as they are
+auto video_pay_sink_caps_query_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      self   = *std::bit_cast<RealSelf*>(data);
+    const auto query  = GST_PAD_PROBE_INFO_QUERY(info);
+    const auto height = self.sender_max_height.load();
+    if(!(info->type & GST_PAD_PROBE_TYPE_PULL) || GST_QUERY_TYPE(query) != GST_QUERY_CAPS || height <= 0) {
+        return GST_PAD_PROBE_OK;
+    }
+    auto result = (GstCaps*)(nullptr);
+    gst_query_parse_caps_result(query, &result);
+    if(result == NULL) {
+        return GST_PAD_PROBE_OK;
+    }
+    const auto filter = AutoGstCaps(gst_caps_copy(result));
+    for(auto i = 0u; i < gst_caps_get_size(filter.get()); i += 1) {
+        gst_structure_set(gst_caps_get_structure(filter.get(), i),
+                          "height", GST_TYPE_INT_RANGE, 1, height,
+                          NULL);
+    }
+    const auto limited = AutoGstCaps(gst_caps_intersect(result, filter.get()));
+    gst_query_set_caps_result(query, limited.get());
+    return GST_PAD_PROBE_OK;
+}
+
+auto audio_pay_sink_mute_probe(GstPad* const /*pad*/, GstPadProbeInfo* const /*info*/, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<RealSelf*>(data);
+    return self.audio_muted.load() ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+// how late the buffer is against the clock of the pad's element, 0 if unknown
+auto get_lateness(GstPad* const pad, GstBuffer* const buffer) -> guint64 {
+    const auto event   = AutoGstEvent(gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0));
+    const auto element = AutoGstObject(gst_pad_get_parent_element(pad));
+    if(event.get() == NULL || element.get() == NULL || !GST_BUFFER_PTS_IS_VALID(buffer)) {
+        return 0;
+    }
+    auto segment = (const GstSegment*)(nullptr);
+    gst_event_parse_segment(event.get(), &segment);
+    const auto buffer_time = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+    const auto now         = gst_element_get_current_running_time(element.get());
+    if(!GST_CLOCK_TIME_IS_VALID(buffer_time) || !GST_CLOCK_TIME_IS_VALID(now) || now <= buffer_time) {
+        return 0;
+    }
+    return now - buffer_time;
+}
+
+// minimum latency of the elements feeding video_sink, which is expected lateness rather than backlog
+auto get_upstream_video_latency(RealSelf& self, GstPad* const pay_sink_pad) -> guint64 {
+    if(const auto latency = self.upstream_video_latency.load(); latency != GST_CLOCK_TIME_NONE) {
+        return latency;
+    }
+    auto       latency = GstClockTime(0);
+    const auto query   = gst_query_new_latency();
+    if(gst_pad_peer_query(pay_sink_pad, query) == TRUE) {
+        auto live = gboolean();
+        auto max  = GstClockTime();
+        gst_query_parse_latency(query, &live, &latency, &max);
+    }
+    gst_query_unref(query);
+    LOG_DEBUG(logger, "upstream video latency {}ms", latency / GST_MSECOND);
+    self.upstream_video_latency.store(latency);
+    return latency;
+}
+
+// the time a frame has spent on the send path, excluding upstream latency
+// lateness at the payloader covers backlog upstream of video_sink,
+// lateness at nicesink covers the pacer, rtpbin and encryption as well
+auto get_send_delay(RealSelf& self, GstPad* const pay_sink_pad, GstBuffer* const buffer) -> guint64 {
+    const auto lateness = std::max(get_lateness(pay_sink_pad, buffer), self.sent_video_lateness.load());
+    const auto latency  = get_upstream_video_latency(self, pay_sink_pad);
+    return lateness > latency ? lateness - latency : 0;
+}
+
+// upstream latency changed, query it again
+auto video_pay_sink_latency_event_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<RealSelf*>(data);
+    if(GST_EVENT_TYPE(GST_PAD_PROBE_INFO_EVENT(info)) == GST_EVENT_LATENCY) {
+        self.upstream_video_latency.store(GST_CLOCK_TIME_NONE);
+    }
+    return GST_PAD_PROBE_OK;
+}
 
+auto video_pay_sink_mute_probe(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<RealSelf*>(data);
+    if(self.video_muted.load() || self.sender_max_height.load() == 0) {
+        return GST_PAD_PROBE_DROP;
+    }
+    // buffers reaching the payloader are whole frames, so dropping here never leaves a partial one
+    const auto buffer = info->type & GST_PAD_PROBE_TYPE_BUFFER ? GST_PAD_PROBE_INFO_BUFFER(info) : gst_buffer_list_get(GST_PAD_PROBE_INFO_BUFFER_LIST(info), 0);
+    if(!self.video_wait_keyframe.load()) {
+        if(self.props.send_latency_budget == 0) {
+            return GST_PAD_PROBE_OK;
+        }
+        const auto delay = get_send_delay(self, pad, buffer);
+        self.send_delay.store(delay);
+        if(delay <= guint64(self.props.send_latency_budget) * GST_MSECOND) {
+            return GST_PAD_PROBE_OK;
+        }
+        // skip the backlog up to a fresh keyframe instead of sending it late
+        LOG_DEBUG(logger, "send delay {}ms exceeds the budget, dropping video until the next keyframe", delay / GST_MSECOND);
+        self.video_drop_stale.store(true);
+        self.video_wait_keyframe.store(true);
+        self.latency_budget_drops.fetch_add(1);
+        gst_pad_push_event(pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+        return GST_PAD_PROBE_DROP;
+    }
+    // frames before the forced keyframe reference ones we did not send
+    if(GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+        if(self.video_drop_stale.load()) {
+            self.latency_budget_drops.fetch_add(1);
+        }
+        return GST_PAD_PROBE_DROP;
+    }
+    self.video_drop_stale.store(false);
+    self.video_wait_keyframe.store(false);
+    return GST_PAD_PROBE_OK;
+}
+
+// desc is a structure whose fields are netsim properties
+auto create_netsim(const std::string& desc) -> GstElement* {
+    const auto props = AutoGstStructure(gst_structure_from_string(desc.data(), NULL));
+    ensure(props.get() != NULL, "invalid netsim description {}", desc);
+    const auto netsim = gst_element_factory_make("netsim", NULL);
+    ensure(netsim != NULL, "failed to create netsim");
+    gst_structure_foreach(
+        props.get(),
+        [](const GQuark field, const GValue* const value, const gpointer data) -> gboolean {
+            g_object_set_property(G_OBJECT(data), g_quark_to_string(field), value);
+            return TRUE;
+        },
+        netsim);
+    return netsim;
+}
+
+// rtp headers are not encrypted by srtp and buffer timestamps are kept through rtpbin and dtlssrtpenc
+auto nicesink_video_lateness_probe(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      self = *std::bit_cast<RealSelf*>(data);
+    const auto ssrc = self.video_ssrc.load();
+    const auto list = info->type & GST_PAD_PROBE_TYPE_BUFFER ? nullptr : GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    const auto size = list == nullptr ? 1u : gst_buffer_list_length(list);
+    for(auto i = 0u; i < size; i += 1) {
+        const auto buffer = list == nullptr ? GST_PAD_PROBE_INFO_BUFFER(info) : gst_buffer_list_get(list, i);
+        auto       rtp    = GstRTPBuffer(GST_RTP_BUFFER_INIT);
+        if(gst_rtp_buffer_map(buffer, GST_MAP_READ, &rtp) == FALSE) {
+            continue; // dtls or rtcp
+        }
+        const auto matched = gst_rtp_buffer_get_ssrc(&rtp) == ssrc;
+        gst_rtp_buffer_unmap(&rtp);
+        if(matched) {
+            self.sent_video_lateness.store(get_lateness(pad, buffer));
+        }
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+// elements stay in NULL state until they are configured by finalize_sub_pipeline
+auto add_sub_pipeline_element(RealSelf& self, GstElement* const element) -> bool {
+    gst_element_set_locked_state(element, TRUE);
+    ensure(call_vfunc(self, add_element, element) == TRUE);
+    self.sub_pipeline.elements.push_back(element);
+    return true;
+}
+
+// create and link the elements that do not depend on jingle, while the conference join is in progress
+auto preconstruct_sub_pipeline(RealSelf& self) -> bool {
     // rtpbin
     const auto rtpbin = gst_element_factory_make("rtpbin", "rtpbin");
     ensure(rtpbin != NULL, "failed to create rtpbin");
@@ -375,69 +1229,94 @@ auto construct_sub_pipeline(RealSelf& self) -> bool {
                  "do-lost", TRUE,
                  "do-sync-event", TRUE,
                  NULL);
-    ensure(call_vfunc(self, add_element, rtpbin) == TRUE);
+    ensure(add_sub_pipeline_element(self, rtpbin));
     g_signal_connect(rtpbin, "request-pt-map", G_CALLBACK(rtpbin_request_pt_map_handler), &self);
     g_signal_connect(rtpbin, "new-jitterbuffer", G_CALLBACK(rtpbin_new_jitterbuffer_handler), &self);
     g_signal_connect(rtpbin, "request-aux-sender", G_CALLBACK(rtpbin_request_aux_sender_handler), &self);
     g_signal_connect(rtpbin, "request-aux-receiver", G_CALLBACK(rtpbin_request_aux_receiver_handler), &self);
+    g_signal_connect(rtpbin, "request-fec-decoder", G_CALLBACK(rtpbin_request_fec_decoder_handler), &self);
     g_signal_connect(rtpbin, "pad-added", G_CALLBACK(rtpbin_pad_added_handler), &self);
 
     // nicesrc
     const auto nicesrc = gst_element_factory_make("nicesrc", "nicesrc");
     ensure(nicesrc != NULL, "failed to create nicesrc");
-    g_object_set(nicesrc,
-                 "agent", jingle_session.ice_agent.agent.get(),
-                 "stream", jingle_session.ice_agent.stream_id,
-                 "component", jingle_session.ice_agent.component_id,
-                 NULL);
-    ensure(call_vfunc(self, add_element, nicesrc) == TRUE);
+    ensure(add_sub_pipeline_element(self, nicesrc));
 
     // nicesink
     const auto nicesink = gst_element_factory_make("nicesink", "nicesink");
     ensure(nicesink != NULL, "failed to create nicesink");
     g_object_set(nicesink,
-                 "agent", jingle_session.ice_agent.agent.get(),
-                 "stream", jingle_session.ice_agent.stream_id,
-                 "component", jingle_session.ice_agent.component_id,
                  "sync", FALSE,
                  "async", FALSE,
                  NULL);
-    ensure(call_vfunc(self, add_element, nicesink) == TRUE);
-
-    // unique id for dtls enc/dec pair
-    const auto dtls_conn_id = std::format("gstjitsimeet-{}", serial_num.fetch_add(1));
+    ensure(add_sub_pipeline_element(self, nicesink));
+
+    // netsim, for testing under loss and jitter
+    auto recv_netsim = (GstElement*)(nullptr);
+    auto send_netsim = (GstElement*)(nullptr);
+    if(!self.props.netsim.empty()) {
+        recv_netsim = create_netsim(self.props.netsim);
+        ensure(recv_netsim != nullptr);
+        ensure(add_sub_pipeline_element(self, recv_netsim));
+        send_netsim = create_netsim(self.props.netsim);
+        ensure(send_netsim != nullptr);
+        ensure(add_sub_pipeline_element(self, send_netsim));
+    }
 
     // dtlssrtpenc
     const auto dtlssrtpenc = gst_element_factory_make("dtlssrtpenc", NULL);
     ensure(dtlssrtpenc != NULL, "failed to create dtlssrtpenc");
     g_object_set(dtlssrtpenc,
-                 "connection-id", dtls_conn_id.data(),
                  "is-client", TRUE,
                  NULL);
-    ensure(call_vfunc(self, add_element, dtlssrtpenc) == TRUE);
+    ensure(add_sub_pipeline_element(self, dtlssrtpenc));
 
     // dtlssrtpdec
     const auto dtlssrtpdec = gst_element_factory_make("dtlssrtpdec", NULL);
     ensure(dtlssrtpdec != NULL, "failed to create dtlssrtpdec");
-    g_object_set(dtlssrtpdec,
-                 "connection-id", dtls_conn_id.data(),
-                 "pem", (jingle_session.dtls_cert_pem + "\n" + jingle_session.dtls_priv_key_pem).data(),
-                 NULL);
-    ensure(call_vfunc(self, add_element, dtlssrtpdec) == TRUE);
+    ensure(add_sub_pipeline_element(self, dtlssrtpdec));
+
+    // decrypt workers
+    // dtlssrtpdec still handles dtls, rtcp and packets received before keying
+    auto recv_rtp_src = dtlssrtpdec;
+    auto srtpdecs     = std::vector<GstElement*>();
+    if(self.props.decrypt_workers > 0) {
+        const auto funnel = gst_element_factory_make("funnel", NULL);
+        ensure(funnel != NULL, "failed to create funnel");
+        ensure(add_sub_pipeline_element(self, funnel));
+        ensure(gst_element_link_pads(dtlssrtpdec, "rtp_src", funnel, NULL) == TRUE);
+        const auto srtp_caps = AutoGstCaps(gst_caps_new_empty_simple("application/x-srtp"));
+        for(auto i = 0u; i < self.props.decrypt_workers; i += 1) {
+            const auto appsrc = gst_element_factory_make("appsrc", NULL);
+            ensure(appsrc != NULL, "failed to create appsrc");
+            g_object_set(appsrc,
+                         "caps", srtp_caps.get(),
+                         "format", GST_FORMAT_TIME,
+                         "is-live", TRUE,
+                         "leaky-type", GST_APP_LEAKY_TYPE_DOWNSTREAM,
+                         NULL);
+            ensure(add_sub_pipeline_element(self, appsrc));
+            const auto srtpdec = gst_element_factory_make("srtpdec", NULL);
+            ensure(srtpdec != NULL, "failed to create srtpdec");
+            ensure(add_sub_pipeline_element(self, srtpdec));
+            ensure(gst_element_link_pads(appsrc, NULL, srtpdec, "rtp_sink") == TRUE);
+            ensure(gst_element_link_pads(srtpdec, "rtp_src", funnel, NULL) == TRUE);
+            self.decrypt_workers.add_worker(appsrc, srtpdec);
+            srtpdecs.push_back(srtpdec);
+        }
+        ensure(self.decrypt_workers.install(dtlssrtpdec));
+        recv_rtp_src = funnel;
+    }
 
     // audio payloader
-    unwrap(audio_codec, jingle_session.find_codec_by_type(self.props.audio_codec_type));
     unwrap(audio_pay_name, codec_type_to_payloader_name.find(self.props.audio_codec_type));
     const auto audio_pay = gst_element_factory_make(audio_pay_name.data(), NULL);
     ensure(audio_pay != NULL, "failed to create audio payloader");
-    g_object_set(audio_pay,
-                 "pt", audio_codec.tx_pt,
-                 "ssrc", jingle_session.audio_ssrc,
-                 NULL);
     switch(self.props.audio_codec_type) {
     case CodecType::Opus:
         g_object_set(audio_pay,
-                     "min-ptime", 10u * 1000 * 1000, // 10ms
+                     "min-ptime", gint64(self.props.audio_ptime) * 1000 * 1000,
+                     "dtx", self.props.audio_dtx ? TRUE : FALSE,
                      NULL);
         break;
     default:
@@ -449,17 +1328,33 @@ auto construct_sub_pipeline(RealSelf& self) -> bool {
                      NULL);
         g_signal_connect(audio_pay, "request-extension", G_CALLBACK(pay_depay_request_extension_handler), &self);
     }
-    ensure(call_vfunc(self, add_element, audio_pay) == TRUE);
+    ensure(add_sub_pipeline_element(self, audio_pay));
+    {
+        const auto audio_pay_sink = AutoGstObject(gst_element_get_static_pad(audio_pay, "sink"));
+        ensure(audio_pay_sink.get() != NULL);
+        gst_pad_add_probe(audio_pay_sink.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), audio_pay_sink_mute_probe, &self, NULL);
+    }
+
+    // audio redundancy encoder
+    // placed before rtpfunnel so that video packets are not wrapped
+    auto audio_pay_src = audio_pay;
+    if(self.props.audio_red_distance > 0) {
+        const auto rtpredenc = gst_element_factory_make("rtpredenc", NULL);
+        ensure(rtpredenc != NULL, "failed to create rtpredenc");
+        g_object_set(rtpredenc,
+                     "distance", self.props.audio_red_distance,
+                     "allow-no-red-blocks", TRUE,
+                     NULL);
+        ensure(add_sub_pipeline_element(self, rtpredenc));
+        ensure(gst_element_link_pads(audio_pay, NULL, rtpredenc, NULL) == TRUE);
+        self.sub_pipeline.rtpredenc = rtpredenc;
+        audio_pay_src = rtpredenc;
+    }
 
     // video payloader
-    unwrap(video_codec, jingle_session.find_codec_by_type(self.props.video_codec_type));
     unwrap(video_pay_name, codec_type_to_payloader_name.find(self.props.video_codec_type));
     const auto video_pay = gst_element_factory_make(video_pay_name.data(), NULL);
     ensure(video_pay != NULL, "failed to create video payloader");
-    g_object_set(video_pay,
-                 "pt", video_codec.tx_pt,
-                 "ssrc", jingle_session.video_ssrc,
-                 NULL);
     switch(self.props.video_codec_type) {
     case CodecType::H264:
         g_object_set(video_pay,
@@ -482,28 +1377,171 @@ auto construct_sub_pipeline(RealSelf& self) -> bool {
                      NULL);
         g_signal_connect(video_pay, "request-extension", G_CALLBACK(pay_depay_request_extension_handler), &self);
     }
-    ensure(call_vfunc(self, add_element, video_pay) == TRUE);
+    ensure(add_sub_pipeline_element(self, video_pay));
+    {
+        const auto video_pay_sink = AutoGstObject(gst_element_get_static_pad(video_pay, "sink"));
+        ensure(video_pay_sink.get() != NULL);
+        gst_pad_add_probe(video_pay_sink.get(), GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, video_pay_sink_caps_query_probe, &self, NULL);
+        gst_pad_add_probe(video_pay_sink.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), video_pay_sink_mute_probe, &self, NULL);
+        gst_pad_add_probe(video_pay_sink.get(), GST_PAD_PROBE_TYPE_EVENT_UPSTREAM, video_pay_sink_latency_event_probe, &self, NULL);
+    }
+
+    // video pacer
+    // keyframes would otherwise leave as a line-rate burst and delay audio packets
+    auto video_pay_src = video_pay;
+    if(self.props.video_pacing_rate > 0) {
+        const auto queue = gst_element_factory_make("queue", NULL);
+        ensure(queue != NULL, "failed to create queue");
+        g_object_set(queue,
+                     "max-size-buffers", 0u,
+                     "max-size-bytes", 0u,
+                     "max-size-time", guint64(GST_SECOND),
+                     NULL);
+        ensure(add_sub_pipeline_element(self, queue));
+        ensure(gst_element_link_pads(video_pay, NULL, queue, NULL) == TRUE);
+        ensure(self.pacer.install(queue));
+        video_pay_src = queue;
+    }
 
     // rtpfunnel
     const auto rtpfunnel = gst_element_factory_make("rtpfunnel", NULL);
-    ensure(call_vfunc(self, add_element, rtpfunnel) == TRUE);
+    ensure(add_sub_pipeline_element(self, rtpfunnel));
 
     // link elements
-    // (user) -> audio_pay -> rtpfunnel   -> rtpbin
-    // (user) -> video_pay ->
-    //           nicesrc   -> dtlssrtpdec ->        -> dtlssrtpenc -> nicesink
-    ensure(gst_element_link_pads(audio_pay, NULL, rtpfunnel, NULL) == TRUE);
-    ensure(gst_element_link_pads(video_pay, NULL, rtpfunnel, NULL) == TRUE);
+    // (user) -> audio_pay -> (rtpredenc) ->
+    // (user) -> video_pay -> (pacer)     -> rtpfunnel   -> rtpbin
+    //           nicesrc   -> (netsim) ->    dtlssrtpdec -> (funnel) ->        -> dtlssrtpenc -> (netsim) -> nicesink
+    //                     -> (appsrc  ->    srtpdec)    ->
+    ensure(gst_element_link_pads(audio_pay_src, NULL, rtpfunnel, NULL) == TRUE);
+    ensure(gst_element_link_pads(video_pay_src, NULL, rtpfunnel, NULL) == TRUE);
     ensure(gst_element_link_pads(rtpfunnel, NULL, rtpbin, "send_rtp_sink_0") == TRUE);
-    ensure(gst_element_link_pads(dtlssrtpdec, "rtp_src", rtpbin, "recv_rtp_sink_0") == TRUE);
+    if(recv_rtp_src == dtlssrtpdec) {
+        ensure(gst_element_link_pads(dtlssrtpdec, "rtp_src", rtpbin, "recv_rtp_sink_0") == TRUE);
+    } else {
+        ensure(gst_element_link_pads(recv_rtp_src, NULL, rtpbin, "recv_rtp_sink_0") == TRUE);
+    }
     ensure(gst_element_link_pads(dtlssrtpdec, "rtcp_src", rtpbin, "recv_rtcp_sink_0") == TRUE);
     ensure(gst_element_link_pads(rtpbin, "send_rtp_src_0", dtlssrtpenc, "rtp_sink_0") == TRUE);
     ensure(gst_element_link_pads(rtpbin, "send_rtcp_src_0", dtlssrtpenc, "rtcp_sink_0") == TRUE);
-    ensure(gst_element_link_pads(nicesrc, NULL, dtlssrtpdec, NULL) == TRUE);
-    ensure(gst_element_link_pads(dtlssrtpenc, "src", nicesink, "sink") == TRUE);
+    if(recv_netsim != nullptr) {
+        ensure(gst_element_link_pads(nicesrc, NULL, recv_netsim, NULL) == TRUE);
+        ensure(gst_element_link_pads(recv_netsim, NULL, dtlssrtpdec, NULL) == TRUE);
+        ensure(gst_element_link_pads(dtlssrtpenc, "src", send_netsim, NULL) == TRUE);
+        ensure(gst_element_link_pads(send_netsim, NULL, nicesink, "sink") == TRUE);
+    } else {
+        ensure(gst_element_link_pads(nicesrc, NULL, dtlssrtpdec, NULL) == TRUE);
+        ensure(gst_element_link_pads(dtlssrtpenc, "src", nicesink, "sink") == TRUE);
+    }
+
+    if(self.props.send_latency_budget > 0) {
+        const auto nicesink_sink = AutoGstObject(gst_element_get_static_pad(nicesink, "sink"));
+        ensure(nicesink_sink.get() != NULL);
+        gst_pad_add_probe(nicesink_sink.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), nicesink_video_lateness_probe, &self, NULL);
+    }
+
+    if(self.props.latency_tracing) {
+        // jitterbuffer output and depayloaders are traced when the receive pad is added
+        using Stage  = LatencyTracer::Stage;
+        auto& tracer = self.tracer;
+        ensure(trace_sync_element(tracer, Stage::Decrypt, dtlssrtpdec, "sink", "rtp_src"));
+        for(const auto srtpdec : srtpdecs) {
+            ensure(trace_sync_element(tracer, Stage::Decrypt, srtpdec, "rtp_sink", "rtp_src"));
+        }
+        ensure(trace_sync_element(tracer, Stage::Payload, audio_pay, "sink", "src"));
+        ensure(trace_sync_element(tracer, Stage::Payload, video_pay, "sink", "src"));
+        ensure(trace_sync_element(tracer, Stage::Session, rtpbin, "send_rtp_sink_0", "send_rtp_src_0"));
+        ensure(trace_async_pads(tracer, Stage::Encrypt, dtlssrtpenc, "rtp_sink_0", nicesink, "sink"));
+        const auto jitterbuffer_input = AutoGstObject(gst_element_get_static_pad(rtpbin, "recv_rtp_sink_0"));
+        ensure(jitterbuffer_input.get() != NULL);
+        tracer.trace_async_stage_input(Stage::Jitterbuffer, jitterbuffer_input.get());
+    }
+
+    auto& sub       = self.sub_pipeline;
+    sub.nicesrc     = nicesrc;
+    sub.nicesink    = nicesink;
+    sub.dtlssrtpenc = dtlssrtpenc;
+    sub.dtlssrtpdec = dtlssrtpdec;
+    sub.audio_pay   = audio_pay;
+    sub.video_pay   = video_pay;
+
+    return true;
+}
+
+// fill in session parameters and start the preconstructed elements
+auto finalize_sub_pipeline(RealSelf& self) -> bool {
+    static auto serial_num     = std::atomic_int(0);
+    const auto& jingle_session = self.jingle_handler->get_session();
+    const auto& sub            = self.sub_pipeline;
+    ensure(!sub.elements.empty(), "sub-pipeline is not preconstructed");
+
+    self.audio_hdrext_abs_capture_time = find_hdrext_id(jingle_session.initiate_jingle, "audio", rtp_hdrext_abs_capture_time_uri);
+    self.video_hdrext_abs_capture_time = find_hdrext_id(jingle_session.initiate_jingle, "video", rtp_hdrext_abs_capture_time_uri);
+
+    // ice
+    for(const auto element : {sub.nicesrc, sub.nicesink}) {
+        g_object_set(element,
+                     "agent", jingle_session.ice_agent.agent.get(),
+                     "stream", jingle_session.ice_agent.stream_id,
+                     "component", jingle_session.ice_agent.component_id,
+                     NULL);
+    }
+
+    // unique id for dtls enc/dec pair
+    const auto dtls_conn_id = std::format("gstjitsimeet-{}", serial_num.fetch_add(1));
+    g_object_set(sub.dtlssrtpenc,
+                 "connection-id", dtls_conn_id.data(),
+                 NULL);
+    g_object_set(sub.dtlssrtpdec,
+                 "connection-id", dtls_conn_id.data(),
+                 "pem", (jingle_session.dtls_cert_pem + "\n" + jingle_session.dtls_priv_key_pem).data(),
+                 NULL);
+
+    // payloaders
+    unwrap(audio_codec, jingle_session.find_codec_by_type(self.props.audio_codec_type));
+    g_object_set(sub.audio_pay,
+                 "pt", audio_codec.tx_pt,
+                 "ssrc", jingle_session.audio_ssrc,
+                 NULL);
+    unwrap(video_codec, jingle_session.find_codec_by_type(self.props.video_codec_type));
+    g_object_set(sub.video_pay,
+                 "pt", video_codec.tx_pt,
+                 "ssrc", jingle_session.video_ssrc,
+                 NULL);
+    self.video_ssrc.store(jingle_session.video_ssrc);
+    if(sub.rtpredenc != nullptr) {
+        if(self.opus_red_pt != -1) {
+            g_object_set(sub.rtpredenc,
+                         "pt", self.opus_red_pt,
+                         NULL);
+        } else {
+            // the focus did not offer red, pass packets through unwrapped
+            g_object_set(sub.rtpredenc,
+                         "distance", 0u,
+                         "allow-no-red-blocks", FALSE,
+                         NULL);
+        }
+    }
+    if(sub.rtpreddec != nullptr) {
+        g_object_set(sub.rtpreddec,
+                     "pt", self.opus_red_pt,
+                     NULL);
+    }
+    for(const auto& [pay, id] : {std::pair{sub.audio_pay, self.audio_hdrext_abs_capture_time}, std::pair{sub.video_pay, self.video_hdrext_abs_capture_time}}) {
+        if(id == -1) {
+            continue;
+        }
+        const auto ext = AutoGstObject(abs_capture_time_extension_new());
+        gst_rtp_header_extension_set_id(ext.get(), id);
+        g_signal_emit_by_name(pay, "add-extension", ext.get());
+    }
+
+    for(const auto element : sub.elements) {
+        gst_element_set_locked_state(element, FALSE);
+        ensure(gst_element_sync_state_with_parent(element) == TRUE);
+    }
 
-    self.audio_sink_elements.real_sink = audio_pay;
-    self.video_sink_elements.real_sink = video_pay;
+    self.audio_sink_elements.real_sink = sub.audio_pay;
+    self.video_sink_elements.real_sink = sub.video_pay;
 
     return true;
 }
@@ -548,6 +1586,19 @@ auto replace_stub_sink_with_real_sink(RealSelf& self, RealSelf::SinkElements* co
     return true;
 }
 
+// swap stub sinks to the real ones on the next buffer, then streaming goes on without a gap
+auto leave_standby(RealSelf& self) -> void {
+    if(self.sink_exposed || self.audio_sink_elements.real_sink == nullptr) {
+        // not constructed yet, connect_to_conference exposes it
+        return;
+    }
+    LOG_INFO(logger, "leaving standby");
+    self.sink_exposed = true;
+    self.video_wait_keyframe.store(true);
+    gst_pad_push_event(self.video_sink_elements.sink_pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+    replace_stub_sink_with_real_sink(self);
+}
+
 auto setup_stub_pipeline(RealSelf& self) -> bool {
     for(const auto elements : {&self.audio_sink_elements, &self.video_sink_elements}) {
         auto fakesink = gst_element_factory_make("fakesink", NULL);
@@ -576,6 +1627,7 @@ struct ConferenceCallbacks : public conference::ConferenceCallbacks {
     GstJitsiBin*              jitsibin;
     ws::client::AsyncContext* ws_context;
     JingleHandler*            jingle_handler;
+    StreamManagement*         stream_management;
 
     auto on_participant_joined_left(const conference::Participant& participant, const guint signal, const std::string_view debug_label) -> void {
         LOG_DEBUG(logger, "participant {} id={} nick={}", debug_label, participant.participant_id, participant.nick);
@@ -583,6 +1635,8 @@ struct ConferenceCallbacks : public conference::ConferenceCallbacks {
     }
 
     auto send_payload(std::string_view payload) -> void override {
+        // keep the stanza even if the connection is lost, it will be resent on resumption
+        stream_management->on_send(payload);
         ensure(ws_context->send(payload));
     }
 
@@ -593,6 +1647,7 @@ struct ConferenceCallbacks : public conference::ConferenceCallbacks {
         case jingle::Action::SourceAdd:
             return jingle_handler->on_add_source(std::move(jingle));
         case jingle::Action::SessionTerminate:
+            stream_management->abandon();
             ws_context->shutdown();
             return true;
         default:
@@ -618,7 +1673,7 @@ struct ConferenceCallbacks : public conference::ConferenceCallbacks {
     }
 };
 
-auto pinger_main(conference::Conference& conference) -> coop::Async<void> {
+auto pinger_main(conference::Conference& conference, StreamManagement& stream_management, const std::chrono::seconds interval) -> coop::Async<void> {
     static const auto iq = xmpp::elm::iq.clone()
                                .append_attrs({
                                    {"type", "get"},
@@ -628,16 +1683,14 @@ auto pinger_main(conference::Conference& conference) -> coop::Async<void> {
                                });
 loop:
     conference.send_iq(iq, {});
-    co_await coop::sleep(std::chrono::seconds(10));
+    stream_management.request_ack();
+    co_await coop::sleep(interval);
     goto loop;
 }
 
-auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
+auto connect_ws_context(RealSelf& self, const std::string& ws_path) -> bool {
     const auto& props = self.props;
-
-    const auto ws_path    = std::format("xmpp-websocket?room={}", props.room_name);
-    auto&      ws_context = self.ws_context;
-    coop_ensure(ws_context.init(
+    ensure(self.ws_context.init(
         self.injector,
         {
             .address   = props.server_address.data(),
@@ -646,8 +1699,320 @@ auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
             .port      = 443,
             .ssl_level = props.secure ? ws::client::SSLLevel::Enable : ws::client::SSLLevel::TrustSelfSigned,
         }));
+    self.runner.push_task(self.ws_context.process_until_finish(), &self.ws_task);
+    return true;
+}
+
+// reconnect the websocket and resume the previous xmpp stream
+// jid and muc occupancy are kept, so the conference goes on as if nothing happened
+// prosody gives back the previous anonymous username only if the url carries previd, as lib-jitsi-meet does
+auto resume_stream(RealSelf& self, const std::string& ws_path) -> coop::Async<bool> {
+    auto&      ws_context        = self.ws_context;
+    auto&      stream_management = self.stream_management;
+    const auto previd            = AutoGString(g_uri_escape_string(stream_management.resume_id.data(), NULL, FALSE));
+    coop_ensure(connect_ws_context(self, std::format("{}&previd={}", ws_path, previd.get())));
+
+    auto event   = coop::SingleEvent();
+    auto resumed = false;
+
+    ws_context.handler = [&stream_management, &event, &resumed](const std::span<const std::byte> data) -> coop::Async<void> {
+        switch(stream_management.feed_resume_payload(from_span(data))) {
+        case StreamManagement::FeedResult::Continue:
+            break;
+        case StreamManagement::FeedResult::Resumed:
+            resumed = true;
+            event.notify();
+            break;
+        default:
+            event.notify();
+            break;
+        }
+        co_return;
+    };
+
+    // give up if the new connection is lost too
+    auto watcher_task = coop::TaskHandle();
+    self.runner.push_task(
+        [](ws::client::AsyncContext& ws_context, coop::SingleEvent& event) -> coop::Async<void> {
+            co_await ws_context.disconnected;
+            event.notify();
+        }(ws_context, event),
+        &watcher_task);
+
+    stream_management.start_resume();
+    co_await event;
+    watcher_task.cancel();
+    co_return resumed;
+}
+
+// 0 means that nobody watches our video, it is dropped at the payloader like muted video
+auto apply_sender_max_height(RealSelf& self, const int height) -> void {
+    const auto prev = self.sender_max_height.exchange(height);
+    if(prev == height) {
+        return;
+    }
+    LOG_INFO(logger, "bridge requested sender max height {}", height);
+    g_object_notify(G_OBJECT(self.bin), "sender-max-height");
+
+    // the caps query probe on the payloader applies the new height on renegotiation
+    const auto pad = self.video_sink_elements.sink_pad;
+    if(prev == 0) {
+        self.video_wait_keyframe.store(true);
+        gst_pad_push_event(pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+    }
+    gst_pad_push_event(pad, gst_event_new_reconfigure());
+    gst_pad_push_event(pad, gst_event_new_custom(GST_EVENT_CUSTOM_UPSTREAM,
+                                                 gst_structure_new("jitsi-sender-video-constraints",
+                                                                   "max-height", G_TYPE_INT, height,
+                                                                   NULL)));
+}
+
+auto handle_colibri_message(RealSelf& self, const std::string_view message) -> void {
+    if(const auto height = colibri_message::get_sender_max_height(message)) {
+        apply_sender_max_height(self, *height);
+        return;
+    }
+    if(const auto endpoints = colibri_message::get_forwarded_endpoints(message)) {
+        const auto jitsibin  = GST_JITSIBIN(self.bin);
+        const auto signal    = GST_JITSIBIN_GET_CLASS(jitsibin)->forwarding_changed_signal;
+        auto       forwarded = std::set<std::string>(endpoints->begin(), endpoints->end());
+        for(const auto& id : self.forwarded_participants) {
+            if(!forwarded.contains(id)) {
+                LOG_DEBUG(logger, "bridge stopped forwarding {}", id);
+                g_signal_emit(jitsibin, signal, 0, id.data(), FALSE);
+            }
+        }
+        for(const auto& id : forwarded) {
+            if(!self.forwarded_participants.contains(id)) {
+                LOG_DEBUG(logger, "bridge started forwarding {}", id);
+                g_signal_emit(jitsibin, signal, 0, id.data(), TRUE);
+            }
+        }
+        self.forwarded_participants = std::move(forwarded);
+    }
+}
+
+const auto nice_type_to_candidate_type = make_pair_table<NiceCandidateType, jingle::Jingle::Content::IceUdpTransport::Candidate::Type>({
+    {NICE_CANDIDATE_TYPE_HOST, jingle::Jingle::Content::IceUdpTransport::Candidate::Type::Host},
+    {NICE_CANDIDATE_TYPE_SERVER_REFLEXIVE, jingle::Jingle::Content::IceUdpTransport::Candidate::Type::Srflx},
+    {NICE_CANDIDATE_TYPE_PEER_REFLEXIVE, jingle::Jingle::Content::IceUdpTransport::Candidate::Type::Prflx},
+    {NICE_CANDIDATE_TYPE_RELAYED, jingle::Jingle::Content::IceUdpTransport::Candidate::Type::Relay},
+});
 
-    self.runner.push_task(ws_context.process_until_finish(), &self.ws_task);
+auto build_transport_info(RealSelf& self, NiceAgent* const agent, const NiceCandidate& candidate) -> std::optional<jingle::Jingle> {
+    using Candidate = jingle::Jingle::Content::IceUdpTransport::Candidate;
+
+    const auto& session = self.jingle_handler->get_session();
+    ensure(!session.initiate_jingle.contents.empty());
+    unwrap(type, nice_type_to_candidate_type.find(candidate.type));
+
+    auto ip = std::array<gchar, NICE_ADDRESS_STRING_LEN>();
+    nice_address_to_string(&candidate.addr, ip.data());
+
+    auto ufrag = AutoGString();
+    auto pwd   = AutoGString();
+    ensure(nice_agent_get_local_credentials(agent, candidate.stream_id, &ufrag, &pwd) == TRUE);
+
+    // bundled, so the first content carries the transport
+    auto transport = jingle::Jingle::Content::IceUdpTransport{
+        .pwd   = pwd.get(),
+        .ufrag = ufrag.get(),
+    };
+    transport.candidates.push_back(Candidate{
+        .component  = uint8_t(candidate.component_id),
+        .generation = 0,
+        .port       = uint16_t(nice_address_get_port(&candidate.addr)),
+        .priority   = candidate.priority,
+        .type       = type,
+        .foundation = candidate.foundation,
+        .id         = std::format("jitsibin-trickle-{}", self.trickled_candidates.fetch_add(1)),
+        .ip_addr    = ip.data(),
+    });
+    auto content = jingle::Jingle::Content{
+        .name              = session.initiate_jingle.contents[0].name,
+        .is_from_initiator = true,
+    };
+    content.transports.push_back(std::move(transport));
+    auto ret = jingle::Jingle{
+        .action    = jingle::Action::TransportInfo,
+        .sid       = session.initiate_jingle.sid,
+        .initiator = session.initiate_jingle.initiator,
+        .responder = self.jid.as_full(),
+    };
+    ret.contents.push_back(std::move(content));
+    return ret;
+}
+
+auto send_jingle(RealSelf& self, const jingle::Jingle& jingle, auto on_result) -> bool {
+    unwrap_mut(node, jingle::deparse(jingle));
+    auto iq = xmpp::elm::iq.clone()
+                  .append_attrs({
+                      {"from", self.jid.as_full()},
+                      {"to", self.conference->config.get_muc_local_focus_jid().as_full()},
+                      {"type", "set"},
+                  })
+                  .append_children({
+                      std::move(node),
+                  });
+    self.conference->send_iq(std::move(iq), std::move(on_result));
+    return true;
+}
+
+auto send_transport_info(RealSelf& self, const jingle::Jingle& jingle) -> void {
+    LOG_DEBUG(logger, "trickling candidate {}", jingle.contents[0].transports[0].candidates[0].foundation);
+    send_jingle(self, jingle, [](bool success) -> void {
+        if(!success) {
+            LOG_WARN(logger, "transport-info rejected");
+        }
+    });
+}
+
+auto trickle_candidate(RealSelf& self, NiceAgent* const agent, const NiceCandidate& candidate) -> bool {
+    if(self.conference == nullptr) {
+        return true;
+    }
+    unwrap_mut(jingle, build_transport_info(self, agent, candidate));
+    if(!self.accept_sent) {
+        self.pending_candidates.push_back(std::move(jingle));
+        return true;
+    }
+    send_transport_info(self, jingle);
+    return true;
+}
+
+// the accept may already carry candidates gathered while it was built
+auto flush_pending_candidates(RealSelf& self, const jingle::Jingle& accept) -> void {
+    const auto in_accept = [&accept](const jingle::Jingle::Content::IceUdpTransport::Candidate& candidate) -> bool {
+        for(const auto& content : accept.contents) {
+            for(const auto& transport : content.transports) {
+                for(const auto& c : transport.candidates) {
+                    if(c.ip_addr == candidate.ip_addr && c.port == candidate.port) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    };
+    self.accept_sent = true;
+    for(const auto& jingle : std::exchange(self.pending_candidates, {})) {
+        if(!in_accept(jingle.contents[0].transports[0].candidates[0])) {
+            send_transport_info(self, jingle);
+        }
+    }
+}
+
+// candidates found after session-accept are trickled, instead of waiting for the next renegotiation
+// called on the agent's thread, the jingle is built on the runner thread where the session and jid are safe to read
+auto new_candidate_handler(NiceAgent* const agent, NiceCandidate* const candidate, const gpointer data) -> void {
+    auto& self = *std::bit_cast<RealSelf*>(data);
+    if(candidate->transport != NICE_CANDIDATE_TRANSPORT_UDP || !self.runner_thread.joinable()) {
+        return;
+    }
+    self.injector.inject_task([](RealSelf& self, NiceAgent* const agent, NiceCandidate* const candidate) -> coop::Async<void> {
+        trickle_candidate(self, agent, *candidate);
+        nice_candidate_free(candidate);
+        g_object_unref(agent);
+        co_return;
+    }(self, NICE_AGENT(g_object_ref(agent)), nice_candidate_copy(candidate)));
+}
+
+// tell the focus and the muc that we are leaving, so that the bridge frees our endpoint immediately
+// by default the stanzas are only sent, so that stopping many instances in one pipeline does not add up waits.
+// with leave-timeout, waits for the focus to acknowledge up to that
+auto leave_conference(RealSelf& self) -> coop::Async<void> {
+    if(self.conference == nullptr) {
+        co_return;
+    }
+    const auto begin = gst_util_get_timestamp();
+    auto       done  = coop::SingleEvent();
+
+    const auto& initiate = self.jingle_handler->get_session().initiate_jingle;
+    const auto  accepted = !initiate.sid.empty();
+    const auto  wait     = accepted && self.props.leave_timeout > 0;
+    if(accepted) {
+        const auto terminate = jingle::Jingle{
+            .action    = jingle::Action::SessionTerminate,
+            .sid       = initiate.sid,
+            .initiator = initiate.initiator,
+            .responder = self.jid.as_full(),
+        };
+        // done is gone by the time an unawaited acknowledgement arrives
+        send_jingle(self, terminate, [&done, wait](bool /*success*/) -> void {
+            if(wait) {
+                done.notify();
+            }
+        });
+    }
+
+    const auto presence = xmpp::elm::presence.clone()
+                              .append_attrs({
+                                  {"from", self.jid.as_full()},
+                                  {"to", self.conference->config.get_muc_local_jid().as_full()},
+                                  {"type", "unavailable"},
+                              });
+    // through stream management, so that it is resent if the connection is resumed during the leave
+    self.conference_callbacks->send_payload(presence.dump());
+
+    if(wait) {
+        auto timer = coop::TaskHandle();
+        self.runner.push_task(
+            [](coop::SingleEvent& done, const std::chrono::milliseconds timeout) -> coop::Async<void> {
+                co_await coop::sleep(timeout);
+                LOG_WARN(logger, "session-terminate was not acknowledged in time");
+                done.notify();
+            }(done, std::chrono::milliseconds(self.props.leave_timeout)),
+            &timer);
+        co_await done;
+        timer.cancel();
+    }
+    LOG_INFO(logger, "left conference in {}ms", (gst_util_get_timestamp() - begin) / GST_MSECOND);
+}
+
+auto connect_colibri(RealSelf& self, jingle::Jingle initiate_jingle) -> coop::Async<void> {
+    const auto& props   = self.props;
+    auto        colibri = co_await coop::run_blocking([initiate_jingle = std::move(initiate_jingle), secure = props.secure]() {
+        return colibri::Colibri::connect(initiate_jingle, secure);
+    });
+    if(!colibri) {
+        LOG_ERROR(logger, "failed to connect to colibri, bridge messages are unavailable");
+        co_return;
+    }
+    {
+        auto& colibri_ws   = colibri->ws_context;
+        colibri_ws.handler = [&self, next = std::move(colibri_ws.handler)](const std::span<const std::byte> data) -> coop::Async<void> {
+            handle_colibri_message(self, from_span(data));
+            if(next) {
+                co_await next(data);
+            }
+        };
+    }
+    self.colibri = std::move(colibri);
+    LOG_DEBUG(logger, "colibri connected");
+
+    // messages requested while connecting were dropped, send the latest state instead
+    const auto constraints = [&self] {
+        auto lock = std::lock_guard(self.receiver_constraints_lock);
+        return self.receiver_constraints;
+    }();
+    if(!constraints.empty()) {
+        self.colibri->ws_context.send(constraints);
+    }
+}
+
+auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
+    const auto& props = self.props;
+
+    const auto ws_path    = std::format("xmpp-websocket?room={}", props.room_name);
+    auto&      ws_context = self.ws_context;
+    coop_ensure(connect_ws_context(self, ws_path));
+
+    auto& stream_management          = self.stream_management;
+    stream_management                = StreamManagement();
+    stream_management.server_address = props.server_address;
+    stream_management.send           = [&ws_context](const std::string_view payload) -> void {
+        ensure(ws_context.send(payload));
+    };
 
     auto event = coop::SingleEvent();
     // gain jid from server
@@ -675,30 +2040,53 @@ auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
         self.extenal_services = std::move(negotiator->external_services);
     }
 
+    if(props.stream_management) {
+        stream_management.start();
+    }
+
     // join to conference
-    auto jingle_handler      = JingleHandler(props.audio_codec_type, props.video_codec_type, self.jid, self.extenal_services, &event);
-    auto callbacks           = ConferenceCallbacks();
-    callbacks.jitsibin       = GST_JITSIBIN(self.bin);
-    callbacks.ws_context     = &ws_context;
-    callbacks.jingle_handler = &jingle_handler;
-    self.jingle_handler      = &jingle_handler;
-    const auto conference    = conference::Conference::create(
+    auto jingle_handler         = JingleHandler(props.audio_codec_type, props.video_codec_type, self.jid, self.extenal_services, &event);
+    auto callbacks              = ConferenceCallbacks();
+    callbacks.jitsibin          = GST_JITSIBIN(self.bin);
+    callbacks.ws_context        = &ws_context;
+    callbacks.jingle_handler    = &jingle_handler;
+    callbacks.stream_management = &stream_management;
+    self.jingle_handler         = &jingle_handler;
+    const auto conference       = conference::Conference::create(
         conference::Config{
                .jid              = self.jid,
                .room             = props.room_name,
                .nick             = props.nick,
                .video_codec_type = props.video_codec_type,
-               .audio_muted      = false,
-               .video_muted      = false,
+               .audio_muted      = self.audio_muted.load(),
+               .video_muted      = self.video_muted.load(),
         },
         &callbacks);
-    ws_context.handler = [&conference](const std::span<const std::byte> data) -> coop::Async<void> {
-        conference->feed_payload(from_span(data));
+    const auto conference_handler = [&conference, &stream_management](const std::span<const std::byte> data) -> coop::Async<void> {
+        const auto payload = from_span(data);
+        if(stream_management.feed_payload(payload) == StreamManagement::FeedResult::NotHandled) {
+            conference->feed_payload(payload);
+        }
         co_return;
     };
+    ws_context.handler = conference_handler;
     conference->start_negotiation();
+    self.conference           = conference.get();
+    self.conference_callbacks = &callbacks;
+
+    // jicofo takes a while to allocate the bridge, build what we can meanwhile
+    {
+        const auto begin = gst_util_get_timestamp();
+        coop_ensure(preconstruct_sub_pipeline(self));
+        self.preconstruct_time.store(gst_util_get_timestamp() - begin);
+    }
 
-    if(props.async_sink) {
+    self.sink_exposed                  = false;
+    self.audio_sink_elements.real_sink = nullptr;
+    self.video_sink_elements.real_sink = nullptr;
+    // in standby, stub sinks are kept after construction until the property is cleared
+    const auto stub_sink = props.async_sink || self.standby.load();
+    if(stub_sink) {
         // if there are no participants in the conference, jicofo does not send session-initiate jingle.
         // temporary add fake sinks to pipeline in order to run pipeline immediately.
         coop_ensure(setup_stub_pipeline(self));
@@ -707,20 +2095,55 @@ auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
 
     co_await event;
 
-    const auto colibri = colibri::Colibri::connect(self.jingle_handler->get_session().initiate_jingle, props.secure);
-    coop_ensure(colibri.get() != nullptr);
-    if(props.last_n >= 0) {
-        colibri->set_last_n(props.last_n);
-    }
+    // host candidates are gathered by on_initiate and sent in the accept, connect before the remaining ones arrive.
+    // the ones found until the accept is sent are queued by trickle_candidate
+    g_signal_connect(self.jingle_handler->get_session().ice_agent.agent.get(), "new-candidate-full", G_CALLBACK(new_candidate_handler), &self);
+
+    // send jingle accept before building the pipeline,
+    // so that the connectivity checks and dtls handshake run in parallel with the construction
+    const auto& initiate = self.jingle_handler->get_session().initiate_jingle;
+    self.opus_red_pt     = find_opus_red_pt(self, initiate);
+    coop_unwrap_mut(accept, self.jingle_handler->build_accept_jingle());
+    complete_accept_jingle(self, initiate, accept);
+    accept_abs_capture_time(initiate, accept, "audio");
+    accept_abs_capture_time(initiate, accept, "video");
+    coop_unwrap_mut(accept_node, jingle::deparse(accept));
+    const auto accept_iq = xmpp::elm::iq.clone()
+                               .append_attrs({
+                                   {"from", self.jid.as_full()},
+                                   {"to", conference->config.get_muc_local_focus_jid().as_full()},
+                                   {"type", "set"},
+                               })
+                               .append_children({
+                                   std::move(accept_node),
+                               });
+
+    conference->send_iq(std::move(accept_iq), [](bool success) -> void {
+        ASSERT(success, "failed to send accept iq");
+    });
+    flush_pending_candidates(self, accept);
+
+    // the bridge channel is only for control messages, media setup does not wait for it
+    auto colibri_task = coop::TaskHandle();
+    self.runner.push_task(connect_colibri(self, initiate), &colibri_task);
 
-    // create pipeline based on the jingle information
-    LOG_DEBUG(logger, "creating pipeline");
-    coop_ensure(construct_sub_pipeline(self));
+    // configure pipeline based on the jingle information
+    LOG_DEBUG(logger, "finalizing pipeline");
+    {
+        const auto begin = gst_util_get_timestamp();
+        coop_ensure(finalize_sub_pipeline(self));
+        self.finalize_time.store(gst_util_get_timestamp() - begin);
+    }
+    LOG_INFO(logger, "sub-pipeline preconstructed in {}us, finalized in {}us",
+             self.preconstruct_time.load() / 1000, self.finalize_time.load() / 1000);
 
     // expose real pipeline
-    if(props.async_sink) {
+    if(self.standby.load()) {
+        LOG_INFO(logger, "joined in standby");
+    } else if(stub_sink) {
         // the ghostpad's target is stub sink
         // replace stub sink with real sink
+        self.sink_exposed = true;
         replace_stub_sink_with_real_sink(self);
     } else {
         // the ghostpad has no target
@@ -730,37 +2153,89 @@ auto connect_to_conference(RealSelf& self) -> coop::Async<bool> {
             coop_ensure(real_sink_pad.get() != NULL);
             coop_ensure(gst_ghost_pad_set_target(GST_GHOST_PAD(elements->sink_pad), real_sink_pad.get()) == TRUE);
         }
+        self.sink_exposed = true;
     }
 
-    // send jingle accept
-    coop_unwrap(accept, self.jingle_handler->build_accept_jingle());
-    coop_unwrap_mut(accept_node, jingle::deparse(accept));
-    const auto accept_iq = xmpp::elm::iq.clone()
-                               .append_attrs({
-                                   {"from", self.jid.as_full()},
-                                   {"to", conference->config.get_muc_local_focus_jid().as_full()},
-                                   {"type", "set"},
-                               })
-                               .append_children({
-                                   std::move(accept_node),
-                               });
-
-    conference->send_iq(std::move(accept_iq), [](bool success) -> void {
-        ASSERT(success, "failed to send accept iq");
-    });
-
     self.pipeline_ready.notify();
 
     auto ping_task = coop::TaskHandle();
-    self.runner.push_task(pinger_main(*conference), &ping_task);
-    co_await ws_context.disconnected;
+    self.runner.push_task(pinger_main(*conference, stream_management, std::chrono::seconds(props.keepalive_interval)), &ping_task);
+    while(true) {
+        co_await ws_context.disconnected;
+        if(!stream_management.is_resumable()) {
+            break;
+        }
+        LOG_INFO(logger, "signalling connection lost, resuming stream");
+        if(!co_await resume_stream(self, ws_path)) {
+            LOG_WARN(logger, "failed to resume stream");
+            break;
+        }
+        LOG_INFO(logger, "stream resumed");
+        ws_context.handler = conference_handler;
+    }
     ping_task.cancel();
+    colibri_task.cancel();
+    self.conference           = nullptr;
+    self.conference_callbacks = nullptr;
 
     co_return true;
 }
 
+// audiomixer sums with simd (orc) and applies per-pad volume
+auto setup_audio_mixer(RealSelf& self) -> bool {
+    const auto mixer = gst_element_factory_make("audiomixer", NULL);
+    ensure(mixer != NULL, "failed to create audiomixer");
+    g_object_set(mixer,
+                 "start-time-selection", 1, // first
+                 "ignore-inactive-pads", TRUE,
+                 NULL);
+    ensure(call_vfunc(self, add_element, mixer) == TRUE);
+    ensure(gst_element_sync_state_with_parent(mixer));
+
+    const auto mixer_src_pad = AutoGstObject(gst_element_get_static_pad(mixer, "src"));
+    ensure(mixer_src_pad.get() != NULL);
+    const auto ghost_pad = gst_ghost_pad_new("mixed_audio_src", mixer_src_pad.get());
+    ensure(ghost_pad != NULL);
+    ensure(gst_element_add_pad(GST_ELEMENT(self.bin), ghost_pad) == TRUE);
+    self.audio_mixer = mixer;
+    return true;
+}
+
+auto set_participant_gain(GstJitsiBin* const jitsibin, const gchar* const participant_id, const gdouble gain) -> void {
+    auto& self = *jitsibin->real_self;
+    {
+        auto lock                              = std::lock_guard(self.participant_gains_lock);
+        self.participant_gains[participant_id] = gain;
+    }
+    if(self.audio_mixer == nullptr) {
+        return;
+    }
+    struct Context {
+        const gchar* participant_id;
+        gdouble      gain;
+    };
+    auto context = Context{participant_id, gain};
+    gst_element_foreach_sink_pad(
+        self.audio_mixer,
+        [](GstElement* const /*mixer*/, GstPad* const pad, gpointer const data) -> gboolean {
+            const auto& context = *std::bit_cast<Context*>(data);
+            const auto  id      = (const gchar*)(g_object_get_data(G_OBJECT(pad), participant_id_data_key));
+            if(id != NULL && std::string_view(id) == context.participant_id) {
+                g_object_set(pad, "volume", context.gain, NULL);
+            }
+            return TRUE;
+        },
+        &context);
+}
+
 auto null_to_ready(RealSelf& self) -> bool {
     ensure(self.props.ensure_required_prop());
+    if(self.props.mixed_audio && self.audio_mixer == nullptr) {
+        ensure(setup_audio_mixer(self));
+    }
+    if(self.props.jitterbuffer_pool && self.jitterbuffer_pool == nullptr) {
+        self.jitterbuffer_pool = gst_jitsi_task_pool_new(size_t(self.props.jitterbuffer_stack_size) * 1024);
+    }
     self.runner_thread = std::thread([&self]() {
         self.runner.push_task(
             [](RealSelf& self) -> coop::Async<void> {
@@ -785,6 +2260,7 @@ auto null_to_ready(RealSelf& self) -> bool {
 auto ready_to_null(RealSelf& self) -> bool {
     if(self.runner_thread.joinable()) {
         self.injector.inject_task([](RealSelf& self) -> coop::Async<void> {
+            co_await leave_conference(self);
             self.ws_task.cancel();
             self.connection_task.cancel();
             self.injector.blocker.stop();
@@ -792,12 +2268,65 @@ auto ready_to_null(RealSelf& self) -> bool {
         }(self));
         self.runner_thread.join();
     }
+    self.conference           = nullptr;
+    self.conference_callbacks = nullptr;
+    self.colibri.reset();
+    self.forwarded_participants.clear();
+    self.sender_max_height.store(-1);
+    self.accept_sent = false;
+    self.pending_candidates.clear();
+    // children are in NULL state by now, a new sub-pipeline is built on the next connection
+    for(const auto element : self.sub_pipeline.elements) {
+        gst_element_set_locked_state(element, FALSE);
+        ensure(call_vfunc(self, remove_element, element) == TRUE);
+    }
+    self.sub_pipeline = {};
+    self.decrypt_workers.reset();
+    self.audio_sink_elements.real_sink = nullptr;
+    self.video_sink_elements.real_sink = nullptr;
     if(self.ws_context.state == ws::client::State::Connected) {
         self.ws_context.shutdown();
     }
+    {
+        auto lock = std::lock_guard(self.jitterbuffers_lock);
+        for(const auto& [ssrc, jitterbuffer] : self.jitterbuffers) {
+            gst_object_unref(jitterbuffer.element);
+        }
+        self.jitterbuffers.clear();
+    }
+    if(self.jitterbuffer_pool != nullptr) {
+        // tasks keep their own reference
+        gst_object_unref(self.jitterbuffer_pool);
+        self.jitterbuffer_pool = nullptr;
+    }
     return true;
 }
 
+// run jitterbuffer loops on the shared pool
+// depayloaders and ghost pad pushes are downstream of the jitterbuffer src pad, so they run on the same thread
+// and per-ssrc ordering is kept. the loop blocks while waiting for packets and cannot be multiplexed,
+// so every active stream still occupies a thread. the pool only reuses threads of left participants,
+// keeps idle ones up to the core count and bounds their stack size.
+// benchmarks/task-pool.cpp measures threads, memory and join/leave cost with and without it.
+// rtpjitterbuffer's timer thread is not a GstTask and is not pooled.
+auto handle_message(GstBin* const bin, GstMessage* const message) -> void {
+    auto& self = *GST_JITSIBIN(bin)->real_self;
+    if(self.jitterbuffer_pool != nullptr && GST_MESSAGE_TYPE(message) == GST_MESSAGE_STREAM_STATUS) {
+        auto type  = GstStreamStatusType();
+        auto owner = (GstElement*)(nullptr);
+        gst_message_parse_stream_status(message, &type, &owner);
+        const auto factory = gst_element_get_factory(owner);
+        if(type == GST_STREAM_STATUS_TYPE_CREATE && factory != NULL &&
+           std::string_view(gst_plugin_feature_get_name(factory)) == "rtpjitterbuffer") {
+            const auto object = gst_message_get_stream_status_object(message);
+            if(object != NULL && G_VALUE_HOLDS(object, GST_TYPE_TASK)) {
+                gst_task_set_pool(GST_TASK(g_value_get_object(object)), self.jitterbuffer_pool);
+            }
+        }
+    }
+    GST_BIN_CLASS(parent_class)->handle_message(bin, message);
+}
+
 auto change_state(GstElement* element, const GstStateChange transition) -> GstStateChangeReturn {
     constexpr auto error_value = GST_STATE_CHANGE_FAILURE;
 
@@ -865,6 +2394,12 @@ auto gst_jitsibin_class_init(GstJitsiBinClass* klass) -> void {
     klass->finished_signal = g_signal_new(
         "finished", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
         1, G_TYPE_BOOLEAN);
+    klass->forwarding_changed_signal = g_signal_new(
+        "forwarding-changed", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+        2, G_TYPE_STRING, G_TYPE_BOOLEAN);
+    klass->set_participant_gain_signal = g_signal_new_class_handler(
+        "set-participant-gain", G_TYPE_FROM_CLASS(klass), GSignalFlags(G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION), G_CALLBACK(set_participant_gain), NULL, NULL, NULL, G_TYPE_NONE,
+        2, G_TYPE_STRING, G_TYPE_DOUBLE);
 
     parent_class = g_type_class_peek_parent(klass);
 
@@ -876,6 +2411,9 @@ auto gst_jitsibin_class_init(GstJitsiBinClass* klass) -> void {
 
     const auto element_class    = (GstElementClass*)(klass);
     element_class->change_state = change_state;
+
+    const auto bin_class      = (GstBinClass*)(klass);
+    bin_class->handle_message = handle_message;
     gst_element_class_set_static_metadata(element_class,
                                           "Jitsi Meet Bin",
                                           "Filter/Network/RTP",
@@ -28,6 +28,8 @@ struct GstJitsiBinClass {
     guint participant_left_signal;
     guint mute_state_changed_signal;
     guint finished_signal;
+    guint forwarding_changed_signal;
+    guint set_participant_gain_signal; // action
 };
 
 GType gst_jitsibin_get_type(void);
@@ -0,0 +1,207 @@
+#include <bit>
+#include <optional>
+
+#include "latency-tracer.hpp"
+
+namespace {
+using Stage = LatencyTracer::Stage;
+using Clock = LatencyTracer::Clock;
+
+constexpr auto stage_names = std::array{
+    "decrypt",
+    "jitterbuffer",
+    "depayload",
+    "payload",
+    "session",
+    "encrypt",
+};
+static_assert(stage_names.size() == size_t(Stage::Limit));
+
+// entries of lost packets never leave, forget them at some point
+constexpr auto max_inflight_packets = 8192;
+
+constexpr auto probe_types = GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST);
+
+thread_local auto sync_stage_entries = std::array<Clock::time_point, size_t(Stage::Limit)>();
+
+struct ProbeData {
+    LatencyTracer* tracer;
+    Stage          stage;
+};
+
+auto add_probe(GstPad* const pad, const GstPadProbeCallback callback, LatencyTracer* const tracer, const Stage stage) -> void {
+    gst_pad_add_probe(pad, probe_types, callback, new ProbeData{tracer, stage}, [](gpointer const data) { delete std::bit_cast<ProbeData*>(data); });
+}
+
+auto get_stage(const ProbeData& data) -> LatencyTracer::StageStats& {
+    return data.tracer->stages[size_t(data.stage)];
+}
+
+auto record(LatencyTracer::StageStats& stats, const Clock::duration latency) -> void {
+    const auto ns     = guint64(std::chrono::nanoseconds(latency).count());
+    const auto us     = ns / 1000;
+    const auto bucket = us == 0 ? 0 : std::min(int(std::bit_width(us)) - 1, LatencyTracer::histogram_buckets - 1);
+    stats.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.total.fetch_add(ns, std::memory_order_relaxed);
+}
+
+auto rtp_packet_key(GstBuffer* const buffer) -> std::optional<guint64> {
+    // header is not encrypted in srtp
+    auto header = std::array<guint8, 12>();
+    if(gst_buffer_extract(buffer, 0, header.data(), header.size()) != header.size()) {
+        return std::nullopt;
+    }
+    // not rtp version 2, or rtcp (packet type 192-223)
+    if((header[0] >> 6) != 2 || (header[1] >= 192 && header[1] <= 223)) {
+        return std::nullopt;
+    }
+    const auto seqnum = GST_READ_UINT16_BE(header.data() + 2);
+    const auto ssrc   = GST_READ_UINT32_BE(header.data() + 8);
+    return guint64(ssrc) << 16 | seqnum;
+}
+
+template <class Fn>
+auto for_each_buffer(GstPadProbeInfo* const info, Fn fn) -> void {
+    if(info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        fn(GST_PAD_PROBE_INFO_BUFFER(info));
+    } else {
+        gst_buffer_list_foreach(
+            GST_PAD_PROBE_INFO_BUFFER_LIST(info),
+            [](GstBuffer** const buffer, guint /*index*/, gpointer const data) -> gboolean {
+                (*std::bit_cast<Fn*>(data))(*buffer);
+                return TRUE;
+            },
+            &fn);
+    }
+}
+
+auto sync_input_probe(GstPad* const /*pad*/, GstPadProbeInfo* const /*info*/, gpointer const data) -> GstPadProbeReturn {
+    const auto& probe_data = *std::bit_cast<ProbeData*>(data);
+
+    sync_stage_entries[size_t(probe_data.stage)] = Clock::now();
+    return GST_PAD_PROBE_OK;
+}
+
+auto sync_output_probe(GstPad* const /*pad*/, GstPadProbeInfo* const /*info*/, gpointer const data) -> GstPadProbeReturn {
+    const auto& probe_data = *std::bit_cast<ProbeData*>(data);
+    const auto  entry      = sync_stage_entries[size_t(probe_data.stage)];
+    if(entry != Clock::time_point()) {
+        record(get_stage(probe_data), Clock::now() - entry);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+auto async_input_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      stage = get_stage(*std::bit_cast<ProbeData*>(data));
+    const auto now   = Clock::now();
+    auto       lock  = std::lock_guard(stage.inflight_lock);
+    if(stage.inflight.size() > max_inflight_packets) {
+        stage.inflight.clear();
+    }
+    for_each_buffer(info, [&stage, now](GstBuffer* const buffer) {
+        if(const auto key = rtp_packet_key(buffer)) {
+            stage.inflight[*key] = now;
+        }
+    });
+    return GST_PAD_PROBE_OK;
+}
+
+auto async_output_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      stage = get_stage(*std::bit_cast<ProbeData*>(data));
+    const auto now   = Clock::now();
+    auto       lock  = std::lock_guard(stage.inflight_lock);
+    for_each_buffer(info, [&stage, now](GstBuffer* const buffer) {
+        const auto key = rtp_packet_key(buffer);
+        if(!key) {
+            return;
+        }
+        if(const auto i = stage.inflight.find(*key); i != stage.inflight.end()) {
+            record(stage, now - i->second);
+            stage.inflight.erase(i);
+        }
+    });
+    return GST_PAD_PROBE_OK;
+}
+
+auto count_packets_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto&      counter = *std::bit_cast<LatencyTracer::PacketCounter*>(data);
+    const auto packets = info->type & GST_PAD_PROBE_TYPE_BUFFER ? 1 : gst_buffer_list_length(GST_PAD_PROBE_INFO_BUFFER_LIST(info));
+    counter.packets.fetch_add(packets, std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
+auto append_to_array(GValue* const array, const GType type, auto setter) -> void {
+    auto value = GValue(G_VALUE_INIT);
+    g_value_init(&value, type);
+    setter(&value);
+    gst_value_array_append_and_take_value(array, &value);
+}
+} // namespace
+
+auto LatencyTracer::trace_sync_stage(const Stage stage, GstPad* const input, GstPad* const output) -> void {
+    add_probe(input, sync_input_probe, this, stage);
+    add_probe(output, sync_output_probe, this, stage);
+}
+
+auto LatencyTracer::trace_async_stage_input(const Stage stage, GstPad* const input) -> void {
+    add_probe(input, async_input_probe, this, stage);
+}
+
+auto LatencyTracer::trace_async_stage_output(const Stage stage, GstPad* const output) -> void {
+    add_probe(output, async_output_probe, this, stage);
+}
+
+auto LatencyTracer::count_packets(std::string participant_id, GstPad* const pad) -> void {
+    auto       lock          = std::lock_guard(counters_lock);
+    const auto [i, inserted] = counters.try_emplace(std::move(participant_id));
+    if(inserted) {
+        i->second.last_time = Clock::now();
+    }
+    gst_pad_add_probe(pad, probe_types, count_packets_probe, &i->second, NULL);
+}
+
+auto LatencyTracer::fill_stats(GstStructure* const stats) -> void {
+    auto stage_latencies = GValue(G_VALUE_INIT);
+    gst_value_array_init(&stage_latencies, stages.size());
+    for(auto i = 0uz; i < stages.size(); i += 1) {
+        const auto& stage = stages[i];
+
+        auto histogram = GValue(G_VALUE_INIT);
+        gst_value_array_init(&histogram, histogram_buckets);
+        for(const auto& bucket : stage.histogram) {
+            append_to_array(&histogram, G_TYPE_UINT64, [&bucket](GValue* const value) { g_value_set_uint64(value, bucket.load()); });
+        }
+
+        const auto count     = stage.count.load();
+        const auto structure = gst_structure_new("stage-latency",
+                                                 "stage", G_TYPE_STRING, stage_names[i],
+                                                 "count", G_TYPE_UINT64, count,
+                                                 "mean", G_TYPE_UINT64, count == 0 ? 0 : stage.total.load() / count,
+                                                 NULL);
+        gst_structure_take_value(structure, "histogram", &histogram);
+        append_to_array(&stage_latencies, GST_TYPE_STRUCTURE, [structure](GValue* const value) { g_value_take_boxed(value, structure); });
+    }
+    gst_structure_take_value(stats, "stage-latency", &stage_latencies);
+
+    auto packet_rates = GValue(G_VALUE_INIT);
+    gst_value_array_init(&packet_rates, 0);
+    {
+        const auto now  = Clock::now();
+        auto       lock = std::lock_guard(counters_lock);
+        for(auto& [participant_id, counter] : counters) {
+            const auto packets = counter.packets.load();
+            const auto elapsed = std::chrono::duration<double>(now - counter.last_time).count();
+            const auto rate    = elapsed > 0 ? (packets - counter.last_packets) / elapsed : 0.0;
+            counter.last_packets = packets;
+            counter.last_time    = now;
+
+            const auto structure = gst_structure_new("packet-rate",
+                                                     "participant", G_TYPE_STRING, participant_id.data(),
+                                                     "rate", G_TYPE_DOUBLE, rate,
+                                                     NULL);
+            append_to_array(&packet_rates, GST_TYPE_STRUCTURE, [structure](GValue* const value) { g_value_take_boxed(value, structure); });
+        }
+    }
+    gst_structure_take_value(stats, "packet-rates", &packet_rates);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <gst/gst.h>
+
+// records processing latency of the sub-pipeline stages with pad probes
+// nothing is installed unless tracing is enabled, so disabled tracer costs nothing
+struct LatencyTracer {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage {
+        Decrypt = 0,  // dtlssrtpdec
+        Jitterbuffer, // rtpbin receive side
+        Depayload,    // depayloaders
+        Payload,      // payloaders
+        Session,      // rtpbin send side
+        Encrypt,      // dtlssrtpenc
+        Limit,
+    };
+
+    // bucket n counts latencies in [2^n, 2^(n+1)) microseconds
+    static constexpr auto histogram_buckets = 20;
+
+    struct StageStats {
+        std::array<std::atomic<guint64>, histogram_buckets> histogram;
+        std::atomic<guint64>                                count = 0;
+        std::atomic<guint64>                                total = 0; // in nanoseconds
+
+        // for stages whose input and output run on different threads
+        std::mutex                                     inflight_lock;
+        std::unordered_map<guint64, Clock::time_point> inflight; // ssrc and seqnum to entry time
+    };
+
+    struct PacketCounter {
+        std::atomic<guint64> packets      = 0;
+        guint64              last_packets = 0;
+        Clock::time_point    last_time;
+    };
+
+    std::array<StageStats, size_t(Stage::Limit)> stages;
+
+    std::mutex                           counters_lock;
+    std::map<std::string, PacketCounter> counters; // participant id to counter
+
+    // stage which input and output are processed in the same streaming thread
+    auto trace_sync_stage(Stage stage, GstPad* input, GstPad* output) -> void;
+    // stage which has a thread boundary, packets are matched by ssrc and seqnum
+    auto trace_async_stage_input(Stage stage, GstPad* input) -> void;
+    auto trace_async_stage_output(Stage stage, GstPad* output) -> void;
+    // count rtp packets flowing on the pad
+    auto count_packets(std::string participant_id, GstPad* pad) -> void;
+
+    auto fill_stats(GstStructure* stats) -> void;
+};
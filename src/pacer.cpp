@@ -0,0 +1,130 @@
+#include <bit>
+#include <thread>
+
+#include "gstutil/auto-gst-object.hpp"
+#include "macros/unwrap.hpp"
+#include "pacer.hpp"
+
+namespace {
+// credit an idle sender may accumulate
+constexpr auto max_burst = std::chrono::milliseconds(5);
+
+auto wait_for_budget(Pacer& self, const gsize size) -> void {
+    const auto bitrate = self.bitrate.load();
+    if(bitrate == 0) {
+        return;
+    }
+    const auto now     = Pacer::Clock::now();
+    const auto send_at = std::max(self.next_send, now - max_burst);
+    if(send_at > now) {
+        std::this_thread::sleep_until(send_at);
+    }
+    self.next_send = send_at + std::chrono::nanoseconds(size * 8 * GST_SECOND / bitrate);
+}
+
+auto record_queue_delay(Pacer& self) -> void {
+    auto arrival = Pacer::Clock::time_point();
+    {
+        auto lock = std::lock_guard(self.arrivals_lock);
+        if(self.arrivals.empty()) {
+            return;
+        }
+        arrival = self.arrivals.front();
+        self.arrivals.pop_front();
+    }
+    const auto delay = guint64(std::chrono::nanoseconds(Pacer::Clock::now() - arrival).count());
+    self.queue_delay.store(delay);
+    if(delay > self.max_queue_delay.load()) {
+        self.max_queue_delay.store(delay);
+    }
+}
+
+auto queue_sink_probe(GstPad* const /*pad*/, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<Pacer*>(data);
+    auto  lock = std::lock_guard(self.arrivals_lock);
+    if(info->type & GST_PAD_PROBE_TYPE_EVENT_FLUSH) {
+        if(GST_EVENT_TYPE(GST_PAD_PROBE_INFO_EVENT(info)) == GST_EVENT_FLUSH_STOP) {
+            self.arrivals.clear();
+        }
+    } else {
+        self.arrivals.push_back(Pacer::Clock::now());
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+auto get_probe_data_size(GstPadProbeInfo* const info) -> gsize {
+    if(info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        return gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info));
+    } else {
+        return gst_buffer_list_calculate_size(GST_PAD_PROBE_INFO_BUFFER_LIST(info));
+    }
+}
+
+auto queue_src_probe(GstPad* const pad, GstPadProbeInfo* const info, gpointer const data) -> GstPadProbeReturn {
+    auto& self = *std::bit_cast<Pacer*>(data);
+    if(self.splitting) {
+        // a chunk of the list being split below
+        wait_for_budget(self, get_probe_data_size(info));
+        return GST_PAD_PROBE_OK;
+    }
+
+    record_queue_delay(self);
+
+    if(info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        wait_for_budget(self, gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info)));
+        return GST_PAD_PROBE_OK;
+    }
+
+    // a whole frame in one list would go out as a single burst,
+    // send it in chunks of the burst credit so that audio can interleave
+    // while packets of a chunk still reach nicesink as one batch.
+    const auto bitrate = self.bitrate.load();
+    if(bitrate == 0) {
+        return GST_PAD_PROBE_OK;
+    }
+    const auto list        = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    const auto length      = gst_buffer_list_length(list);
+    const auto chunk_limit = bitrate / 8 * std::chrono::nanoseconds(max_burst).count() / GST_SECOND;
+    self.splitting         = true;
+    for(auto begin = 0u; begin < length;) {
+        auto end        = begin;
+        auto chunk_size = gsize(0);
+        while(end < length && (end == begin || chunk_size < chunk_limit)) {
+            chunk_size += gst_buffer_get_size(gst_buffer_list_get(list, end));
+            end += 1;
+        }
+        const auto chunk = gst_buffer_list_new_sized(end - begin);
+        for(auto i = begin; i < end; i += 1) {
+            gst_buffer_list_add(chunk, gst_buffer_ref(gst_buffer_list_get(list, i)));
+        }
+        const auto ret = gst_pad_push_list(pad, chunk);
+        if(ret != GST_FLOW_OK) {
+            GST_PAD_PROBE_INFO_FLOW_RETURN(info) = ret;
+            break;
+        }
+        begin = end;
+    }
+    self.splitting = false;
+    return GST_PAD_PROBE_DROP;
+}
+} // namespace
+
+auto Pacer::install(GstElement* const queue) -> bool {
+    const auto sink_pad = AutoGstObject(gst_element_get_static_pad(queue, "sink"));
+    ensure(sink_pad.get() != NULL);
+    const auto src_pad = AutoGstObject(gst_element_get_static_pad(queue, "src"));
+    ensure(src_pad.get() != NULL);
+
+    // the previous sub-pipeline may have been stopped with buffers queued
+    {
+        auto lock = std::lock_guard(arrivals_lock);
+        arrivals.clear();
+        queue_delay.store(0);
+        max_queue_delay.store(0);
+    }
+    next_send = Clock::now();
+    splitting = false;
+    gst_pad_add_probe(sink_pad.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_EVENT_FLUSH), queue_sink_probe, this, NULL);
+    gst_pad_add_probe(src_pad.get(), GstPadProbeType(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST), queue_src_probe, this, NULL);
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include <gst/gst.h>
+
+// smooths buffers leaving a queue element against a target bitrate
+struct Pacer {
+    using Clock = std::chrono::steady_clock;
+
+    // bits per second, 0 to pass buffers through without waiting
+    std::atomic<guint64> bitrate = 0;
+
+    // queued time of the buffer most recently sent, in nanoseconds
+    std::atomic<guint64> queue_delay     = 0;
+    std::atomic<guint64> max_queue_delay = 0;
+
+    // following fields are owned by the probes
+    std::mutex                    arrivals_lock;
+    std::deque<Clock::time_point> arrivals;
+    Clock::time_point             next_send;
+    bool                          splitting = false;
+
+    auto install(GstElement* queue) -> bool;
+};
@@ -65,6 +65,23 @@ auto video_codec_type_get_type() -> GType {
 
     return type;
 }
+
+auto output_format_get_type() -> GType {
+    static auto type = GType(0);
+    if(type != 0) {
+        return type;
+    }
+
+    static const auto value = std::array{
+        GEnumValue{std::to_underlying(OutputFormat::Depayloaded), "depayloaded", "Depayloaded elementary streams"},
+        GEnumValue{std::to_underlying(OutputFormat::Rtp), "rtp", "Decrypted RTP packets"},
+        GEnumValue{0, NULL, NULL},
+    };
+
+    type = g_enum_register_static("JitsiBinOutputFormat", value.data());
+
+    return type;
+}
 } // namespace
 
 auto Props::ensure_required_prop() const -> bool {
@@ -106,6 +123,84 @@ auto Props::handle_set_prop(const guint id, const GValue* const value, GParamSpe
     case async_sink_id:
         async_sink = g_value_get_boolean(value) == TRUE;
         return true;
+    case audio_fec_id:
+        audio_fec = g_value_get_boolean(value) == TRUE;
+        return true;
+    case audio_dtx_id:
+        audio_dtx = g_value_get_boolean(value) == TRUE;
+        return true;
+    case audio_red_distance_id:
+        audio_red_distance = g_value_get_uint(value);
+        return true;
+    case audio_ptime_id:
+        audio_ptime = g_value_get_uint(value);
+        return true;
+    case video_pacing_rate_id:
+        video_pacing_rate = g_value_get_uint(value);
+        return true;
+    case rtx_history_packets_id:
+        rtx_history_packets = g_value_get_uint(value);
+        return true;
+    case rtx_history_time_id:
+        rtx_history_time = g_value_get_uint(value);
+        return true;
+    case latency_tracing_id:
+        latency_tracing = g_value_get_boolean(value) == TRUE;
+        return true;
+    case keepalive_interval_id:
+        keepalive_interval = g_value_get_uint(value);
+        return true;
+    case stream_management_id:
+        stream_management = g_value_get_boolean(value) == TRUE;
+        return true;
+    case jitterbuffer_pool_id:
+        jitterbuffer_pool = g_value_get_boolean(value) == TRUE;
+        return true;
+    case jitterbuffer_stack_size_id:
+        jitterbuffer_stack_size = g_value_get_uint(value);
+        return true;
+    case decrypt_workers_id:
+        decrypt_workers = g_value_get_uint(value);
+        return true;
+    case output_format_id:
+        output_format = OutputFormat(g_value_get_enum(value));
+        return true;
+    case keyframe_cache_size_id:
+        keyframe_cache_size = g_value_get_uint(value);
+        return true;
+    case selected_participants_id:
+        selected_participants = g_value_get_string(value);
+        return true;
+    case on_stage_participants_id:
+        on_stage_participants = g_value_get_string(value);
+        return true;
+    case mixed_audio_id:
+        mixed_audio = g_value_get_boolean(value) == TRUE;
+        return true;
+    case silent_audio_level_id:
+        silent_audio_level = g_value_get_uint(value);
+        return true;
+    case audio_muted_id:
+        audio_muted = g_value_get_boolean(value) == TRUE;
+        return true;
+    case video_muted_id:
+        video_muted = g_value_get_boolean(value) == TRUE;
+        return true;
+    case netsim_id:
+        netsim = g_value_get_string(value);
+        return true;
+    case standby_id:
+        standby = g_value_get_boolean(value) == TRUE;
+        return true;
+    case leave_timeout_id:
+        leave_timeout = g_value_get_uint(value);
+        return true;
+    case lazy_receive_id:
+        lazy_receive = g_value_get_boolean(value) == TRUE;
+        return true;
+    case send_latency_budget_id:
+        send_latency_budget = g_value_get_uint(value);
+        return true;
     default:
         return false;
     }
@@ -144,6 +239,84 @@ auto Props::handle_get_prop(const guint id, GValue* const value, GParamSpec* con
     case async_sink_id:
         g_value_set_boolean(value, async_sink ? TRUE : FALSE);
         return true;
+    case audio_fec_id:
+        g_value_set_boolean(value, audio_fec ? TRUE : FALSE);
+        return true;
+    case audio_dtx_id:
+        g_value_set_boolean(value, audio_dtx ? TRUE : FALSE);
+        return true;
+    case audio_red_distance_id:
+        g_value_set_uint(value, audio_red_distance);
+        return true;
+    case audio_ptime_id:
+        g_value_set_uint(value, audio_ptime);
+        return true;
+    case video_pacing_rate_id:
+        g_value_set_uint(value, video_pacing_rate);
+        return true;
+    case rtx_history_packets_id:
+        g_value_set_uint(value, rtx_history_packets);
+        return true;
+    case rtx_history_time_id:
+        g_value_set_uint(value, rtx_history_time);
+        return true;
+    case latency_tracing_id:
+        g_value_set_boolean(value, latency_tracing ? TRUE : FALSE);
+        return true;
+    case keepalive_interval_id:
+        g_value_set_uint(value, keepalive_interval);
+        return true;
+    case stream_management_id:
+        g_value_set_boolean(value, stream_management ? TRUE : FALSE);
+        return true;
+    case jitterbuffer_pool_id:
+        g_value_set_boolean(value, jitterbuffer_pool ? TRUE : FALSE);
+        return true;
+    case jitterbuffer_stack_size_id:
+        g_value_set_uint(value, jitterbuffer_stack_size);
+        return true;
+    case decrypt_workers_id:
+        g_value_set_uint(value, decrypt_workers);
+        return true;
+    case output_format_id:
+        g_value_set_enum(value, std::to_underlying(output_format));
+        return true;
+    case keyframe_cache_size_id:
+        g_value_set_uint(value, keyframe_cache_size);
+        return true;
+    case selected_participants_id:
+        g_value_set_string(value, selected_participants.data());
+        return true;
+    case on_stage_participants_id:
+        g_value_set_string(value, on_stage_participants.data());
+        return true;
+    case mixed_audio_id:
+        g_value_set_boolean(value, mixed_audio ? TRUE : FALSE);
+        return true;
+    case silent_audio_level_id:
+        g_value_set_uint(value, silent_audio_level);
+        return true;
+    case audio_muted_id:
+        g_value_set_boolean(value, audio_muted ? TRUE : FALSE);
+        return true;
+    case video_muted_id:
+        g_value_set_boolean(value, video_muted ? TRUE : FALSE);
+        return true;
+    case netsim_id:
+        g_value_set_string(value, netsim.data());
+        return true;
+    case standby_id:
+        g_value_set_boolean(value, standby ? TRUE : FALSE);
+        return true;
+    case leave_timeout_id:
+        g_value_set_uint(value, leave_timeout);
+        return true;
+    case lazy_receive_id:
+        g_value_set_boolean(value, lazy_receive ? TRUE : FALSE);
+        return true;
+    case send_latency_budget_id:
+        g_value_set_uint(value, send_latency_budget);
+        return true;
     default:
         return false;
     }
@@ -206,7 +379,7 @@ auto Props::install_props(GObjectClass* const obj) -> void {
         obj, jitterbuffer_latency_id,
         g_param_spec_uint("jitterbuffer-latency",
                           NULL,
-                          "Jitterbuffer latency in milliseconds",
+                          "Jitterbuffer latency in milliseconds, of video streams or all streams with rtp output-format",
                           0, std::numeric_limits<guint>::max(), 200,
                           rw_construct));
 
@@ -218,9 +391,165 @@ auto Props::install_props(GObjectClass* const obj) -> void {
                          -1, std::numeric_limits<int>::max(), 0,
                          rw_construct));
 
+    g_object_class_install_property(
+        obj, audio_red_distance_id,
+        g_param_spec_uint("audio-red-distance",
+                          NULL,
+                          "Number of previous audio packets carried as RED redundancy, if the focus offers red (0 to disable RED)",
+                          0, 2, 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, audio_ptime_id,
+        g_param_spec_uint("audio-ptime",
+                          NULL,
+                          "Minimum audio packetisation time in milliseconds",
+                          10, 120, 10,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, video_pacing_rate_id,
+        g_param_spec_uint("video-pacing-rate",
+                          NULL,
+                          "Rate in kbps to pace outgoing video packets at, audio is never delayed (0 to disable pacing)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, rtx_history_packets_id,
+        g_param_spec_uint("rtx-history-packets",
+                          NULL,
+                          "Number of sent video packets kept for retransmission (0 for unlimit)",
+                          0, std::numeric_limits<guint>::max(), 100,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, rtx_history_time_id,
+        g_param_spec_uint("rtx-history-time",
+                          NULL,
+                          "Duration in milliseconds of sent video packets kept for retransmission (0 for unlimit)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, keepalive_interval_id,
+        g_param_spec_uint("keepalive-interval",
+                          NULL,
+                          "Interval in seconds between xmpp pings",
+                          1, std::numeric_limits<guint>::max(), 10,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, leave_timeout_id,
+        g_param_spec_uint("leave-timeout",
+                          NULL,
+                          "Milliseconds to wait for session-terminate to be acknowledged when leaving, each instance waits in turn on READY to NULL (0 to send it without waiting)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, send_latency_budget_id,
+        g_param_spec_uint("send-latency-budget",
+                          NULL,
+                          "Milliseconds a video frame may spend on the send path, beyond the latency reported by upstream elements, before frames are dropped up to the next keyframe (0 to disable)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, jitterbuffer_stack_size_id,
+        g_param_spec_uint("jitterbuffer-stack-size",
+                          NULL,
+                          "Stack size in KiB of threads in the jitterbuffer pool (0 for the system default)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, decrypt_workers_id,
+        g_param_spec_uint("decrypt-workers",
+                          NULL,
+                          "Number of threads decrypting received srtp, sharded by ssrc (0 to decrypt on the receiving thread)",
+                          0, 64, 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, output_format_id,
+        g_param_spec_enum("output-format",
+                          NULL,
+                          "Format of received streams, rtp exposes packets released from jitterbuffer without depayloading (jitterbuffer-latency then applies to audio too, set it to 0 to release packets on arrival)",
+                          output_format_get_type(),
+                          guint(OutputFormat::Depayloaded),
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, keyframe_cache_size_id,
+        g_param_spec_uint("keyframe-cache-size",
+                          NULL,
+                          "Maximum bytes of received video kept since the last keyframe and replayed to newly linked pads (0 to disable)",
+                          0, std::numeric_limits<guint>::max(), 0,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, selected_participants_id,
+        g_param_spec_string("selected-participants",
+                            NULL,
+                            "Comma separated participant ids whose camera the bridge should prefer when choosing receive-limit streams",
+                            "",
+                            rw_construct));
+
+    g_object_class_install_property(
+        obj, on_stage_participants_id,
+        g_param_spec_string("on-stage-participants",
+                            NULL,
+                            "Comma separated participant ids shown large, the bridge sends their camera in high resolution",
+                            "",
+                            rw_construct));
+
+    g_object_class_install_property(
+        obj, silent_audio_level_id,
+        g_param_spec_uint("silent-audio-level",
+                          NULL,
+                          "With mixed-audio, packets at or below -N dBov by their ssrc-audio-level are not decoded (127 skips only digital silence), applies to streams received afterwards",
+                          0, 127, 127,
+                          rw_construct));
+
+    g_object_class_install_property(
+        obj, netsim_id,
+        g_param_spec_string("netsim",
+                            NULL,
+                            "Insert netsim on both directions of the network path for testing, e.g. \"netsim, drop-probability=0.05, delay-distribution=normal, min-delay=10, max-delay=60\"",
+                            "",
+                            rw_construct));
+
+    g_object_class_install_property(
+        obj, sender_max_height_id,
+        g_param_spec_int("sender-max-height",
+                         NULL,
+                         "Highest video resolution the bridge wants from us (-1 for unknown, 0 when nobody receives our video, which is then not sent)",
+                         -1, std::numeric_limits<int>::max(), -1,
+                         GParamFlags(G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY)));
+
+    g_object_class_install_property(
+        obj, stats_id,
+        g_param_spec_boxed("stats",
+                           NULL,
+                           "Runtime statistics",
+                           GST_TYPE_STRUCTURE,
+                           GParamFlags(G_PARAM_READABLE)));
+
     bool_prop(secure_id, "insecure", "Trust server self-signed certification", FALSE);
     bool_prop(async_sink_id, "force-play", "Force pipeline to play even in conference with no participants", FALSE);
+    bool_prop(audio_fec_id, "audio-fec", "Signal Opus in-band FEC in session-accept and use it when decoding mixed audio (enable inband-fec on the upstream encoder too)", FALSE);
+    bool_prop(audio_dtx_id, "audio-dtx", "Signal Opus DTX in session-accept and do not send empty audio packets", FALSE);
+    bool_prop(stream_management_id, "stream-management", "Enable XEP-0198 stream management to resume signalling after a brief disconnect", FALSE);
+    bool_prop(mixed_audio_id, "mixed-audio", "Decode and mix all received audio into a mixed_audio_src pad, added when going to READY. Received audio is then not exposed as per-participant pads, video still is", FALSE);
+    bool_prop(audio_muted_id, "audio-muted", "Stop sending audio and announce it as muted", FALSE);
+    bool_prop(video_muted_id, "video-muted", "Stop sending video and announce it as muted", FALSE);
+    bool_prop(lazy_receive_id, "lazy-receive", "Create depayloaders only while received stream pads are linked, packets of unlinked pads are dropped", FALSE);
+    bool_prop(standby_id, "standby", "Join and receive, but keep sink pads on stub sinks until cleared, for switching rooms without a gap", FALSE);
+    bool_prop(jitterbuffer_pool_id, "jitterbuffer-pool", "Run jitterbuffer output, depayloading and pad pushes on threads reused across streams, each active stream still occupies one thread", FALSE);
+    bool_prop(latency_tracing_id, "latency-tracing", "Record per-stage processing latency into stats", FALSE);
 
     gst_type_mark_as_plugin_api(audio_codec_type_get_type(), GstPluginAPIFlags(0));
     gst_type_mark_as_plugin_api(video_codec_type_get_type(), GstPluginAPIFlags(0));
+    gst_type_mark_as_plugin_api(output_format_get_type(), GstPluginAPIFlags(0));
 }
@@ -5,6 +5,11 @@
 
 #include "jitsi/codec-type.hpp"
 
+enum class OutputFormat {
+    Depayloaded = 1,
+    Rtp,
+};
+
 struct Props {
     enum {
         server_address_id = 1,
@@ -16,17 +21,71 @@ struct Props {
         jitterbuffer_latency_id,
         secure_id,
         async_sink_id,
+        audio_fec_id,
+        audio_dtx_id,
+        audio_red_distance_id,
+        audio_ptime_id,
+        video_pacing_rate_id,
+        rtx_history_packets_id,
+        rtx_history_time_id,
+        stats_id,
+        latency_tracing_id,
+        keepalive_interval_id,
+        stream_management_id,
+        jitterbuffer_pool_id,
+        jitterbuffer_stack_size_id,
+        decrypt_workers_id,
+        output_format_id,
+        keyframe_cache_size_id,
+        selected_participants_id,
+        on_stage_participants_id,
+        sender_max_height_id,
+        mixed_audio_id,
+        silent_audio_level_id,
+        audio_muted_id,
+        video_muted_id,
+        netsim_id,
+        standby_id,
+        leave_timeout_id,
+        lazy_receive_id,
+        send_latency_budget_id,
     };
 
-    std::string server_address;
-    std::string room_name;
-    std::string nick;
-    CodecType   audio_codec_type;
-    CodecType   video_codec_type;
-    int         last_n;
-    guint       jitterbuffer_latency;
-    bool        secure;
-    bool        async_sink;
+    std::string  server_address;
+    std::string  room_name;
+    std::string  nick;
+    CodecType    audio_codec_type;
+    CodecType    video_codec_type;
+    int          last_n;
+    guint        jitterbuffer_latency;
+    bool         secure;
+    bool         async_sink;
+    bool         audio_fec;
+    bool         audio_dtx;
+    guint        audio_red_distance;
+    guint        audio_ptime;
+    guint        video_pacing_rate;
+    guint        rtx_history_packets;
+    guint        rtx_history_time;
+    bool         latency_tracing;
+    guint        keepalive_interval;
+    bool         stream_management;
+    bool         jitterbuffer_pool;
+    guint        jitterbuffer_stack_size; // KiB, for pooled threads
+    guint        decrypt_workers;
+    OutputFormat output_format;
+    guint        keyframe_cache_size;
+    std::string  selected_participants; // comma separated participant ids
+    std::string  on_stage_participants;
+    bool         mixed_audio;
+    guint        silent_audio_level; // -dBov, from the ssrc-audio-level extension
+    bool         audio_muted;
+    bool         video_muted;
+    std::string  netsim; // netsim properties as a structure, empty to disable
+    bool         standby;
+    guint        leave_timeout; // milliseconds, 0 to not wait
+    bool         lazy_receive;
+    guint        send_latency_budget; // milliseconds, 0 to disable
 
     auto ensure_required_prop() const -> bool;
     auto handle_set_prop(const guint id, const GValue* value, GParamSpec* spec) -> bool;
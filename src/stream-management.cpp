@@ -0,0 +1,211 @@
+#include <format>
+#include <optional>
+
+#include "jitsi/macros/logger.hpp"
+#include "jitsi/util/charconv.hpp"
+#include "stream-management.hpp"
+
+namespace {
+auto logger = Logger("stream-management");
+
+constexpr auto sm_ns      = "urn:xmpp:sm:3";
+constexpr auto framing_ns = "urn:ietf:params:xml:ns:xmpp-framing";
+constexpr auto sasl_ns    = "urn:ietf:params:xml:ns:xmpp-sasl";
+
+// websocket framing carries exactly one top-level element per message,
+// only the start tag of it is needed here.
+struct RootElement {
+    std::string_view name;
+    std::string_view attrs;
+
+    auto find_attr(const std::string_view key) const -> std::optional<std::string_view> {
+        auto rest = attrs;
+        while(true) {
+            const auto eq = rest.find('=');
+            if(eq == rest.npos || eq + 1 >= rest.size()) {
+                return std::nullopt;
+            }
+            auto name = rest.substr(0, eq);
+            if(const auto i = name.find_first_not_of(" \t\r\n"); i != name.npos) {
+                name = name.substr(i);
+            }
+            const auto quote = rest[eq + 1];
+            const auto end   = rest.find(quote, eq + 2);
+            if(end == rest.npos) {
+                return std::nullopt;
+            }
+            const auto value = rest.substr(eq + 2, end - eq - 2);
+            if(name == key) {
+                return value;
+            }
+            rest = rest.substr(end + 1);
+        }
+    }
+};
+
+auto parse_root(const std::string_view payload) -> std::optional<RootElement> {
+    const auto begin = payload.find('<');
+    if(begin == payload.npos) {
+        return std::nullopt;
+    }
+    const auto tag_end = payload.find('>', begin);
+    if(tag_end == payload.npos) {
+        return std::nullopt;
+    }
+    const auto tag      = payload.substr(begin + 1, tag_end - begin - 1);
+    const auto name_end = std::min(tag.find_first_of(" \t\r\n/"), tag.size());
+    return RootElement{
+        .name  = tag.substr(0, name_end),
+        .attrs = tag.substr(name_end),
+    };
+}
+
+auto is_stanza(const std::string_view name) -> bool {
+    return name == "iq" || name == "message" || name == "presence";
+}
+
+auto acknowledge(StreamManagement& self, const uint32_t handled) -> void {
+    // counters wrap around at 2^32
+    const auto count = handled - self.outbound_acked;
+    if(count > self.unacked.size()) {
+        LOG_WARN(logger, "server acknowledged {} stanzas but only {} were sent", count, self.unacked.size());
+        self.unacked.clear();
+    } else {
+        self.unacked.erase(self.unacked.begin(), self.unacked.begin() + count);
+    }
+    self.outbound_acked = handled;
+}
+
+auto parse_handled(const RootElement& elm) -> std::optional<uint32_t> {
+    const auto h = elm.find_attr("h");
+    if(!h) {
+        return std::nullopt;
+    }
+    return from_chars<uint32_t>(*h);
+}
+} // namespace
+
+auto StreamManagement::start() -> void {
+    send(std::format(R"(<enable xmlns="{}" resume="true"/>)", sm_ns));
+    enable_sent = true;
+}
+
+auto StreamManagement::request_ack() -> void {
+    if(!enabled) {
+        return;
+    }
+    send(std::format(R"(<r xmlns="{}"/>)", sm_ns));
+}
+
+auto StreamManagement::on_send(const std::string_view payload) -> void {
+    if(!enable_sent) {
+        return;
+    }
+    if(const auto elm = parse_root(payload); elm && is_stanza(elm->name)) {
+        unacked.emplace_back(payload);
+    }
+}
+
+auto StreamManagement::feed_payload(const std::string_view payload) -> FeedResult {
+    const auto elm = parse_root(payload);
+    if(!elm) {
+        return FeedResult::NotHandled;
+    }
+    if(is_stanza(elm->name)) {
+        if(enabled) {
+            inbound_handled += 1;
+        }
+        return FeedResult::NotHandled;
+    }
+    if(elm->find_attr("xmlns") != sm_ns) {
+        return FeedResult::NotHandled;
+    }
+
+    if(elm->name == "enabled") {
+        enabled = true;
+        if(const auto resume = elm->find_attr("resume"); resume == "true" || resume == "1") {
+            resume_id = elm->find_attr("id").value_or("");
+        }
+        LOG_INFO(logger, "stream management enabled resumable={}", !resume_id.empty());
+    } else if(elm->name == "r") {
+        send(std::format(R"(<a xmlns="{}" h="{}"/>)", sm_ns, inbound_handled));
+    } else if(elm->name == "a") {
+        if(const auto handled = parse_handled(*elm)) {
+            acknowledge(*this, *handled);
+        }
+    } else if(elm->name == "failed") {
+        LOG_WARN(logger, "server refused to enable stream management");
+        abandon();
+    } else {
+        return FeedResult::NotHandled;
+    }
+    return FeedResult::Handled;
+}
+
+auto StreamManagement::is_resumable() const -> bool {
+    return enabled && !resume_id.empty();
+}
+
+auto StreamManagement::start_resume() -> void {
+    resume_state = ResumeState::WaitAuthFeatures;
+    send(std::format(R"(<open xmlns="{}" to="{}" version="1.0"/>)", framing_ns, server_address));
+}
+
+auto StreamManagement::feed_resume_payload(const std::string_view payload) -> FeedResult {
+    const auto elm = parse_root(payload);
+    if(!elm) {
+        return FeedResult::Failed;
+    }
+    if(elm->name == "open") {
+        return FeedResult::Continue;
+    }
+    const auto is_features = elm->name == "stream:features" || elm->name == "features";
+
+    switch(resume_state) {
+    case ResumeState::WaitAuthFeatures:
+        if(is_features) {
+            send(std::format(R"(<auth xmlns="{}" mechanism="ANONYMOUS"/>)", sasl_ns));
+            resume_state = ResumeState::WaitAuthResult;
+        }
+        return FeedResult::Continue;
+    case ResumeState::WaitAuthResult:
+        if(elm->name == "success") {
+            send(std::format(R"(<open xmlns="{}" to="{}" version="1.0"/>)", framing_ns, server_address));
+            resume_state = ResumeState::WaitResumeFeatures;
+            return FeedResult::Continue;
+        }
+        LOG_WARN(logger, "authentication failed during resumption");
+        break;
+    case ResumeState::WaitResumeFeatures:
+        if(is_features) {
+            send(std::format(R"(<resume xmlns="{}" h="{}" previd="{}"/>)", sm_ns, inbound_handled, resume_id));
+            resume_state = ResumeState::WaitResumed;
+        }
+        return FeedResult::Continue;
+    case ResumeState::WaitResumed:
+        if(elm->name == "resumed") {
+            if(const auto handled = parse_handled(*elm)) {
+                acknowledge(*this, *handled);
+            }
+            // server lost these stanzas
+            for(const auto& stanza : unacked) {
+                send(stanza);
+            }
+            resume_state = ResumeState::Idle;
+            return FeedResult::Resumed;
+        }
+        LOG_WARN(logger, "server refused to resume the stream");
+        break;
+    case ResumeState::Idle:
+        break;
+    }
+    resume_state = ResumeState::Idle;
+    abandon();
+    return FeedResult::Failed;
+}
+
+auto StreamManagement::abandon() -> void {
+    enabled = false;
+    resume_id.clear();
+    unacked.clear();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// xep-0198 stream management over the xmpp websocket
+struct StreamManagement {
+    enum class FeedResult {
+        NotHandled, // payload is not for us, pass it to the conference
+        Handled,
+        Continue, // resumption is in progress
+        Resumed,
+        Failed,
+    };
+
+    enum class ResumeState {
+        Idle,
+        WaitAuthFeatures,
+        WaitAuthResult,
+        WaitResumeFeatures,
+        WaitResumed,
+    };
+
+    std::string                            server_address;
+    std::function<void(std::string_view)> send;
+
+    bool                    enable_sent     = false;
+    bool                    enabled         = false;
+    std::string             resume_id;           // empty if the server does not allow resumption
+    uint32_t                inbound_handled = 0; // number of stanzas received
+    uint32_t                outbound_acked  = 0; // number of our stanzas acknowledged by the server
+    std::deque<std::string> unacked;             // sent but not acknowledged stanzas
+    ResumeState             resume_state = ResumeState::Idle;
+
+    // request the server to enable stream management with resumption
+    auto start() -> void;
+    auto request_ack() -> void;
+    // record outgoing payload
+    auto on_send(std::string_view payload) -> void;
+    auto feed_payload(std::string_view payload) -> FeedResult;
+
+    auto is_resumable() const -> bool;
+    // call after the websocket is reconnected
+    auto start_resume() -> void;
+    auto feed_resume_payload(std::string_view payload) -> FeedResult;
+    // forget the session so that it will not be resumed
+    auto abandon() -> void;
+};
@@ -0,0 +1,173 @@
+#include <bit>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <pthread.h>
+
+#include "task-pool.hpp"
+
+#define gst_jitsi_task_pool_parent_class parent_class
+G_DEFINE_TYPE(GstJitsiTaskPool, gst_jitsi_task_pool, GST_TYPE_TASK_POOL);
+
+namespace {
+struct Job {
+    GstTaskPoolFunction func;
+    gpointer            data;
+
+    std::mutex              lock;
+    std::condition_variable cond;
+    bool                    done     = false;
+    bool                    disposed = false; // nobody will join this job
+};
+} // namespace
+
+struct TaskPoolSelf {
+    size_t stack_size;
+    // threads kept for future streams, others exit after their job
+    size_t max_idle_workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::mutex              lock;
+    std::condition_variable cond;
+    std::deque<Job*>        pending;
+    size_t                  workers      = 0;
+    size_t                  idle_workers = 0;
+    bool                    stopping     = false;
+};
+
+namespace {
+auto run_job(Job* const job) -> void {
+    job->func(job->data);
+
+    auto lock = std::unique_lock(job->lock);
+    job->done = true;
+    if(job->disposed) {
+        lock.unlock();
+        delete job;
+        return;
+    }
+    job->cond.notify_all();
+}
+
+auto worker_main(void* const data) -> void* {
+    auto& self = *std::bit_cast<TaskPoolSelf*>(data);
+    auto  lock = std::unique_lock(self.lock);
+    while(true) {
+        self.idle_workers += 1;
+        self.cond.wait(lock, [&self] { return self.stopping || !self.pending.empty(); });
+        self.idle_workers -= 1;
+        if(self.pending.empty()) {
+            break;
+        }
+        const auto job = self.pending.front();
+        self.pending.pop_front();
+
+        lock.unlock();
+        run_job(job);
+        lock.lock();
+
+        if(self.idle_workers >= self.max_idle_workers) {
+            break;
+        }
+    }
+    self.workers -= 1;
+    self.cond.notify_all();
+    return NULL;
+}
+
+auto spawn_worker(TaskPoolSelf& self, GError** const error) -> bool {
+    auto attr = pthread_attr_t();
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if(self.stack_size != 0) {
+        pthread_attr_setstacksize(&attr, self.stack_size);
+    }
+    auto       thread = pthread_t();
+    const auto ret    = pthread_create(&thread, &attr, worker_main, &self);
+    pthread_attr_destroy(&attr);
+    if(ret != 0) {
+        g_set_error(error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED, "failed to create thread: %s", g_strerror(ret));
+        return false;
+    }
+    self.workers += 1;
+    return true;
+}
+
+auto prepare(GstTaskPool* const /*pool*/, GError** const /*error*/) -> void {
+    // threads are created on demand
+}
+
+auto cleanup(GstTaskPool* const /*pool*/) -> void {
+}
+
+auto push(GstTaskPool* const pool, const GstTaskPoolFunction func, const gpointer user_data, GError** const error) -> gpointer {
+    auto&      self = *GST_JITSI_TASK_POOL(pool)->real_self;
+    const auto job  = new Job{.func = func, .data = user_data};
+
+    auto lock = std::lock_guard(self.lock);
+    if(self.idle_workers <= self.pending.size() && !spawn_worker(self, error)) {
+        delete job;
+        return NULL;
+    }
+    self.pending.push_back(job);
+    self.cond.notify_one();
+    return job;
+}
+
+auto join(GstTaskPool* const /*pool*/, const gpointer id) -> void {
+    const auto job = std::bit_cast<Job*>(id);
+    {
+        auto lock = std::unique_lock(job->lock);
+        job->cond.wait(lock, [job] { return job->done; });
+    }
+    delete job;
+}
+
+auto dispose_handle(GstTaskPool* const /*pool*/, const gpointer id) -> void {
+    const auto job = std::bit_cast<Job*>(id);
+    {
+        auto lock = std::lock_guard(job->lock);
+        if(!job->done) {
+            job->disposed = true;
+            return;
+        }
+    }
+    delete job;
+}
+
+auto finalize(GObject* const object) -> void {
+    const auto self = GST_JITSI_TASK_POOL(object)->real_self;
+    {
+        // wait for idle workers to exit
+        auto lock      = std::unique_lock(self->lock);
+        self->stopping = true;
+        self->cond.notify_all();
+        self->cond.wait(lock, [self] { return self->workers == 0; });
+    }
+    delete self;
+    G_OBJECT_CLASS(parent_class)->finalize(object);
+}
+} // namespace
+
+auto gst_jitsi_task_pool_init(GstJitsiTaskPool* const pool) -> void {
+    pool->real_self = new TaskPoolSelf();
+}
+
+auto gst_jitsi_task_pool_class_init(GstJitsiTaskPoolClass* const klass) -> void {
+    const auto gobject_class = (GObjectClass*)(klass);
+    gobject_class->finalize  = finalize;
+
+    const auto pool_class      = (GstTaskPoolClass*)(klass);
+    pool_class->prepare        = prepare;
+    pool_class->cleanup        = cleanup;
+    pool_class->push           = push;
+    pool_class->join           = join;
+    pool_class->dispose_handle = dispose_handle;
+}
+
+auto gst_jitsi_task_pool_new(const size_t stack_size) -> GstTaskPool* {
+    const auto pool             = GST_JITSI_TASK_POOL(g_object_new(GST_TYPE_JITSI_TASK_POOL, NULL));
+    pool->real_self->stack_size = stack_size;
+    return &pool->pool;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <gst/gst.h>
+
+extern "C" {
+G_BEGIN_DECLS
+#define GST_TYPE_JITSI_TASK_POOL (gst_jitsi_task_pool_get_type())
+#define GST_JITSI_TASK_POOL(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_JITSI_TASK_POOL, GstJitsiTaskPool))
+
+struct TaskPoolSelf;
+
+// task pool whose threads have a bounded stack size and are reused across streams
+struct GstJitsiTaskPool {
+    GstTaskPool pool;
+
+    TaskPoolSelf* real_self;
+};
+
+struct GstJitsiTaskPoolClass {
+    GstTaskPoolClass parent_class;
+};
+
+GType gst_jitsi_task_pool_get_type(void);
+
+G_END_DECLS
+}
+
+// stack_size in bytes, 0 for system default
+auto gst_jitsi_task_pool_new(size_t stack_size) -> GstTaskPool*;